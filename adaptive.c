@@ -0,0 +1,194 @@
+// ******************************************************************************************************************
+//  CPU Scheduler
+//  Copyright(C) 2018  James LoForti
+//  Contact Info: jamesloforti@gmail.com
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.If not, see<https://www.gnu.org/licenses/>.
+//									     ____.           .____             _____  _______   
+//									    |    |           |    |    ____   /  |  | \   _  \  
+//									    |    |   ______  |    |   /  _ \ /   |  |_/  /_\  \ 
+//									/\__|    |  /_____/  |    |__(  <_> )    ^   /\  \_/   \
+//									\________|           |_______ \____/\____   |  \_____  /
+//									                             \/          |__|        \/ 
+//
+// ******************************************************************************************************************
+//
+
+//Adaptive round robin: rr with a quantum sized per job and per turn. A job's slice grows with
+//the cpu time it has had so far, so a cpu bound job stops paying for a switch every few units
+//while a short one still goes quickly, and it's cut so a turn of the whole run queue fits in
+//a target latency, so a long queue still gets round quickly. Both are held within bounds.
+//Before the run, fixed rr is run quietly over the same table so the report can set the
+//switches saved against the response time lost
+
+#include <stdio.h> // needed for printf()
+#include <inttypes.h> // needed for PRId64
+#include "p5.h"
+
+//Adaptive quantum globals
+PER_THREAD int adaptiveQuantum; // size each slice instead of using the one quantum
+PER_THREAD SimTime adaptiveMin; // bounds from -b, 0 = the defaults below
+PER_THREAD SimTime adaptiveMax;
+PER_THREAD SimTime adaptiveLatency;
+PER_THREAD int contextSwitches; // dispatches from the run queue in the last rr run
+PER_THREAD int fixedSwitches = -1; // of the fixed quantum run, -1 if there was none
+PER_THREAD double fixedResponseTime;
+PER_THREAD char* fixedSkipped; // why fixed rr wasn't run alongside, for the report
+
+int parse_adaptive(char* text)
+{
+	//min:max[:latency]
+	long long low = 0;
+	long long high = 0;
+	long long latency = 0;
+	int fields = sscanf(text, "%lld:%lld:%lld", &low, &high, &latency);
+	if (fields < 2 || low < 1 || high < low || (fields == 3 && latency < 1))
+	{
+		return 0;
+	}
+
+	adaptiveMin = (SimTime)low;
+	adaptiveMax = (SimTime)high;
+	adaptiveLatency = (SimTime)latency;
+	return 1;
+} // end function parse_adaptive()
+
+void adaptive_bounds(SimTime* low, SimTime* high, SimTime* latency)
+{
+	//By default a slice runs from a fraction of the quantum to a multiple of it,
+	//and a turn of the queue should take no longer than the longest slice
+	*low = adaptiveMin ? adaptiveMin : ((quantum / ADAPTIVE_SHRINK > 0) ? (quantum / ADAPTIVE_SHRINK) : 1);
+	*high = adaptiveMax ? adaptiveMax : (quantum * ADAPTIVE_GROW);
+	*high = (*high > *low) ? *high : *low;
+	*latency = adaptiveLatency ? adaptiveLatency : *high;
+} // end function adaptive_bounds()
+
+void arr()
+{
+	//Fixed rr first, quietly, over a copy of the table. A run that checkpoints or replays
+	//edits can't be repeated like this, so it goes without the comparison
+	fixedSwitches = -1;
+	fixedSkipped = whatIfMode ? "a what-if run" : ((checkpointInterval > 0) ? "a checkpointed run" : NULL);
+	if (fixedSkipped == NULL)
+	{
+		ProcessTable original = { 0 };
+		table_reserve(&original, processes.capacity);
+		table_copy(&original, &processes, numProcesses + 1);
+
+		int wasQuiet = quiet;
+		quiet = 1;
+		rr();
+		quiet = wasQuiet;
+		fixedSwitches = contextSwitches;
+		fixedResponseTime = summary.responseTime;
+
+		init_all();
+		table_copy(&processes, &original, numProcesses + 1);
+		table_destructor(&original);
+	} // end if
+
+	adaptiveQuantum = 1;
+	rr();
+	adaptiveQuantum = 0;
+} // end function arr()
+
+void resume_arr()
+{
+	fixedSwitches = -1;
+	fixedSkipped = "a resumed run";
+	adaptiveQuantum = 1;
+	run_rr();
+	adaptiveQuantum = 0;
+} // end function resume_arr()
+
+SimTime adaptive_quantum(int pid)
+{
+	SimTime low, high, latency;
+	adaptive_bounds(&low, &high, &latency);
+
+	//A job that has run long is likely to run longer, so it gets as long again as it has
+	//had: all its time since arrival not spent waiting. Wait times are summed up to now
+	SimTime served = simClock - processes.arrivalTime[pid] - processes.waitTime[pid];
+	SimTime grant = (served > quantum) ? served : quantum;
+
+	//But cut it so everyone waiting gets a turn within the latency
+	SimTime share = latency / (waitingList.count + 1);
+	grant = (grant < share) ? grant : share;
+
+	return (grant < low) ? low : ((grant > high) ? high : grant);
+} // end function adaptive_quantum()
+
+void start_slice(int pid)
+{
+	//Fixed rr carries on with whatever the job has left of its quantum
+	if (adaptiveQuantum)
+	{
+		processes.remainingQuantum[pid] = adaptive_quantum(pid);
+	}
+} // end function start_slice()
+
+void renew_slice(int pid)
+{
+	//Fixed rr starts every slice at the one quantum
+	if (!adaptiveQuantum)
+	{
+		processes.remainingQuantum[pid] = quantum;
+	}
+	else if (waitingList.count)
+	{
+		//Leave no quantum, so the runner yields and its next slice is sized when it's picked again
+		processes.remainingQuantum[pid] = 0;
+	}
+	else
+	{
+		//Nobody to yield to, so it carries straight on with a new slice
+		start_slice(pid);
+	}
+} // end function renew_slice()
+
+char* adaptive_label(char* buffer, size_t size)
+{
+	if (!adaptiveQuantum)
+	{
+		snprintf(buffer, size, "Round Robin (w/ quantum %" PRId64 ")", quantum);
+		return buffer;
+	}
+
+	SimTime low, high, latency;
+	adaptive_bounds(&low, &high, &latency);
+	snprintf(buffer, size, "Adaptive Round Robin (w/ quantum %" PRId64 " to %" PRId64 ")", low, high);
+	return buffer;
+} // end function adaptive_label()
+
+void print_adaptive()
+{
+	printf("\tContext Switches: %d", contextSwitches);
+
+	//Set against fixed rr, when it was run alongside
+	if (fixedSwitches < 0)
+	{
+		printf("\n\tNo comparison with fixed rr in %s\n", fixedSkipped);
+		return;
+	}
+
+	//Label times with their unit, when the workload declared one
+	char* unit = (outputUnit != NULL) ? outputUnit->name : "";
+	char* space = (outputUnit != NULL) ? " " : "";
+
+	printf(" vs %d at quantum %" PRId64 " (%+.1f%%)\n", fixedSwitches, quantum,
+			fixedSwitches ? (100.0 * (contextSwitches - fixedSwitches) / fixedSwitches) : 0);
+	printf("\tAVG Response Time: %.2f%s%s vs %.2f%s%s at quantum %" PRId64 " (%+.1f%%)\n",
+			summary.responseTime, space, unit, fixedResponseTime, space, unit, quantum,
+			fixedResponseTime ? (100 * (summary.responseTime - fixedResponseTime) / fixedResponseTime) : 0);
+} // end function print_adaptive()
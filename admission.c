@@ -0,0 +1,212 @@
+// ******************************************************************************************************************
+//  CPU Scheduler
+//  Copyright(C) 2018  James LoForti
+//  Contact Info: jamesloforti@gmail.com
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.If not, see<https://www.gnu.org/licenses/>.
+//									     ____.           .____             _____  _______   
+//									    |    |           |    |    ____   /  |  | \   _  \  
+//									    |    |   ______  |    |   /  _ \ /   |  |_/  /_\  \ 
+//									/\__|    |  /_____/  |    |__(  <_> )    ^   /\  \_/   \
+//									\________|           |_______ \____/\____   |  \_____  /
+//									                             \/          |__|        \/ 
+//
+// ******************************************************************************************************************
+//
+
+//Admission control: a bounded run queue for srtf and rr. When a job arrives to a full queue
+//one job is shed, by the admission policy: the newcomer (reject), the job that has waited
+//longest (oldest), the lowest weight (priority), or the one with the least slack left
+//before its deadline (deadline). Shed jobs never run and are reported apart from the rest
+
+#include <stdlib.h> 
+#include <stdio.h> // needed for printf()
+#include <string.h> // needed for strcmp()
+#include <inttypes.h> // needed for INT64_MAX
+#include "p5.h"
+
+PER_THREAD int queueCapacity; // jobs allowed to wait, 0 = unbounded
+PER_THREAD char* admission = "reject";
+
+char* admissionPolicies[] = { "reject", "oldest", "priority", "deadline", NULL };
+
+char* find_admission(const char* name)
+{
+	int i;
+	for (i = 0; admissionPolicies[i] != NULL; i++)
+	{
+		if (strcmp(admissionPolicies[i], name) == 0)
+		{
+			return admissionPolicies[i];
+		}
+	}
+
+	return NULL;
+} // end function find_admission()
+
+void admit_to_waiting(int pid)
+{
+	//Room left, or already queued: send_to_waiting turns duplicates away
+	Node probe = { NULL, pid };
+	if (queueCapacity <= 0 || waitingList.count < queueCapacity || duplicate(&waitingList, &probe))
+	{
+		send_to_waiting(pid);
+		return;
+	}
+
+	//Full, so someone goes
+	int victim = choose_victim(pid);
+	shed_process(victim);
+
+	//If it was one already waiting, the newcomer takes its place
+	if (victim != pid)
+	{
+		remove_pid(&waitingList, victim);
+		send_to_waiting(pid);
+	}
+} // end function admit_to_waiting()
+
+int choose_victim(int pid)
+{
+	//Reject never disturbs the queue
+	if (strcmp(admission, "reject") == 0)
+	{
+		return pid;
+	}
+
+	//Otherwise weigh the newcomer against everyone waiting who hasn't run yet. A preempted
+	//job has already had cpu time, so shedding it would break "shed jobs never run"
+	int victim = pid;
+	Node* next = waitingList.first;
+	while (next != NULL)
+	{
+		if (!processes.started[next->pid] && shed_before(next->pid, victim))
+		{
+			victim = next->pid;
+		}
+		next = next->next;
+	}
+
+	return victim;
+} // end function choose_victim()
+
+int shed_before(int a, int b)
+{
+	//Drop the head of the line, the earliest arrival
+	if (strcmp(admission, "oldest") == 0)
+	{
+		if (processes.arrivalTime[a] != processes.arrivalTime[b])
+		{
+			return processes.arrivalTime[a] < processes.arrivalTime[b];
+		}
+		return a < b;
+	}
+
+	//Drop the lowest weight, or the job least likely to make its deadline anyway
+	if (strcmp(admission, "priority") == 0)
+	{
+		if (processes.weight[a] != processes.weight[b])
+		{
+			return processes.weight[a] < processes.weight[b];
+		}
+	}
+	else
+	{
+		SimTime slackA = job_slack(a);
+		SimTime slackB = job_slack(b);
+		if (slackA != slackB)
+		{
+			return slackA < slackB;
+		}
+	}
+
+	//Ties go against the later arrival, so work already waiting is kept
+	return a > b;
+} // end function shed_before()
+
+SimTime job_slack(int pid)
+{
+	//Jobs without a deadline can always wait
+	if (!processes.deadline[pid])
+	{
+		return INT64_MAX;
+	}
+
+	//Burst time holds what's left for a preempted job
+	return processes.arrivalTime[pid] + processes.deadline[pid] - simClock - processes.burstTime[pid];
+} // end function job_slack()
+
+void shed_process(int pid)
+{
+	//Retire the job without running it
+	processes.shed[pid] = 1;
+	processes.flag[pid] = -1;
+	processes.waiting[pid] = 0;
+	processes.endTime[pid] = simClock;
+	processesRemaining--;
+} // end function shed_process()
+
+int gather_admitted(SimTime* rows)
+{
+	//Copy the measured columns of every admitted job, one column after another
+	SimTime* arrival = rows;
+	SimTime* start = rows + numProcesses;
+	SimTime* end = rows + (2 * numProcesses);
+	SimTime* wait = rows + (3 * numProcesses);
+
+	int count = 0;
+	int i;
+	for (i = 0; i < numProcesses; i++)
+	{
+		if (!processes.shed[i])
+		{
+			arrival[count] = processes.arrivalTime[i];
+			start[count] = processes.startTime[i];
+			end[count] = processes.endTime[i];
+			wait[count] = processes.waitTime[i];
+			count++;
+		}
+	} // end for
+
+	return count;
+} // end function gather_admitted()
+
+SimTime admitted_p99(SimTime* arrival, SimTime* end, int count)
+{
+	SimTime* turnTimes = malloc(sizeof(SimTime) * (count + 1));
+	int i;
+	for (i = 0; i < count; i++)
+	{
+		turnTimes[i] = end[i] - arrival[i];
+	}
+	qsort(turnTimes, count, sizeof(SimTime), compare_times);
+
+	//Nearest rank
+	SimTime p99 = count ? turnTimes[(int)((((long long)count * 99) + 99) / 100) - 1] : 0;
+	free(turnTimes);
+
+	return p99;
+} // end function admitted_p99()
+
+void print_admission()
+{
+	//Label times with their unit, when the workload declared one
+	char* unit = (outputUnit != NULL) ? outputUnit->name : "";
+	char* space = (outputUnit != NULL) ? " " : "";
+
+	printf("\tShed Jobs (queue of %d, %s): %d of %d (%.2f%%)\n"
+			"\tP99 Turnaround Time (admitted): %.2f%s%s\n",
+			queueCapacity, admission, summary.shedJobs, numProcesses, (100.0 * summary.shedJobs) / numProcesses,
+			summary.p99TurnTime, space, unit);
+} // end function print_admission()
@@ -0,0 +1,560 @@
+// ******************************************************************************************************************
+//  CPU Scheduler
+//  Copyright(C) 2018  James LoForti
+//  Contact Info: jamesloforti@gmail.com
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.If not, see<https://www.gnu.org/licenses/>.
+//									     ____.           .____             _____  _______   
+//									    |    |           |    |    ____   /  |  | \   _  \  
+//									    |    |   ______  |    |   /  _ \ /   |  |_/  /_\  \ 
+//									/\__|    |  /_____/  |    |__(  <_> )    ^   /\  \_/   \
+//									\________|           |_______ \____/\____   |  \_____  /
+//									                             \/          |__|        \/ 
+//
+// ******************************************************************************************************************
+//
+
+//Regression bench: runs a fixed matrix of workload shapes and sizes through every algorithm,
+//checks the averages against golden values and compares throughput and peak memory with a
+//stored baseline. Each case runs in its own child process, so its peak memory is its own,
+//and is timed over as many repetitions as fit a time budget: the median is compared, with a threshold that widens
+//when either run was noisy, up to a cap. A noisy case is timed again and the quietest timing counts,
+//and a failing one is timed again before it counts as a regression. -u records the baseline
+//from several passes over every case, keeping each case's slowest rate.
+//Exits non-zero on any drift or regression.
+//A few small workloads with averages worked out by hand run first, each once.
+//The plugin case runs the example stride plugin, and its row also shows the cost of
+//dispatching through the plugin interface, against the built in stride just before it.
+//	p5bench baseline	check against the baseline
+//	p5bench -u baseline	rewrite the baseline from this machine
+
+#include <stdlib.h> 
+#include <stdio.h> // needed for printf()
+#include <string.h> // needed for strcmp()
+#include <math.h> // needed for log()
+#include <time.h> // needed for clock_gettime()
+#include <unistd.h> // needed for fork()
+#include <sys/resource.h> // needed for wait4()
+#include <sys/wait.h>
+#include "p5.h"
+
+char* benchShapes[] = { "steady", "poisson", "heavy", NULL };
+int benchSizes[] = { 1000, 10000, 100000, 0 };
+char* benchPolicies[] = { "fcfs", "sjf", "srtf", "rr", "lottery", "stride", BENCH_PLUGIN_POLICY, "group", NULL };
+BenchCheck benchChecks[] =
+{
+	//Jobs arriving together start one after another, never before the previous one is done
+	{ "clustered-fcfs", "fcfs", QUANTUM, 0, 0, "219:203 219:47 219:206 220:392 220:267 221:142 221:55 221:14", 679.125, 844.875, 679.125 },
+	//On the tick a slice runs out, the preempted job goes behind the one waiting
+	{ "tick-rr", "rr", 4, 1, 0, "0:10 0:3", 2, 10, 3.5 },
+	//A job running alone takes a fresh slice at each slice end, so a newcomer waits for the next one
+	{ "tick-rr-alone", "rr", 4, 1, 0, "5:100 11:20", 1, 79, 19 },
+	//A resumed run keeps the quantum it was checkpointed with, for the job still to arrive too
+	{ "resumed-rr", "rr", 7, 0, 5, "0:20 2:10 20:10", 3, 79.0 / 3, 13 },
+	{ NULL, NULL, 0, 0, 0, NULL, 0, 0, 0 }
+};
+char* quadraticPolicies[] = { "sjf", "srtf", "rr", NULL }; // rescan every job per event, so kept to small sizes
+
+int main(int argc, char* argv[])
+{
+	int update = (argc == 3 && strcmp(argv[1], "-u") == 0);
+	if (argc != 2 && !update)
+	{
+		fprintf(stderr, "usage: %s [-u] baseline\n", argv[0]);
+		return 1;
+	}
+	char* path = argv[argc - 1];
+
+	if (!load_plugin(BENCH_PLUGIN))
+	{
+		fprintf(stderr, "%s: %s: %s\n", argv[0], BENCH_PLUGIN, pluginError);
+		return 1;
+	}
+
+	//Load the stored results, unless they're being replaced
+	BenchResult* baseline = NULL;
+	int baselineCount = update ? 0 : read_baseline(path, &baseline);
+	if (baselineCount < 0)
+	{
+		perror(path);
+		return 1;
+	}
+
+	FILE* out = NULL;
+	if (update)
+	{
+		out = fopen(path, "w");
+		if (out == NULL)
+		{
+			perror(path);
+			return 1;
+		}
+		fprintf(out, "#case\tjobs/s\tspread\tpeak KB\tresponse\tturnaround\twait\n");
+	}
+
+	printf("%-28s %12s %8s %10s  %s\n", "case", "jobs/s", "spread", "peak KB", "result");
+
+	//The hand checked workloads, then every shape, size and algorithm
+	int failures = 0;
+	int k;
+	for (k = 0; benchChecks[k].name != NULL; k++)
+	{
+		failures += !run_check(&benchChecks[k]);
+	}
+
+	//A stored rate is the slowest of several passes over the whole matrix, since the machine can
+	//run fast or slow for minutes at a time and one such stretch shouldn't set the bar
+	int caseCount = 0;
+	int s, n, p;
+	for (s = 0; benchShapes[s] != NULL; s++)
+	{
+		for (n = 0; benchSizes[n]; n++)
+		{
+			for (p = 0; benchPolicies[p] != NULL; p++)
+			{
+				caseCount++;
+			}
+		}
+	}
+	BenchResult* recorded = calloc(caseCount, sizeof(BenchResult));
+	int passes = update ? BENCH_RECORDS : 1;
+	int pass;
+	for (pass = 0; pass < passes; pass++)
+	{
+		double builtinRate = 0; // the plugin's built in counterpart, at the current shape and size
+		int caseIndex = 0;
+		for (s = 0; benchShapes[s] != NULL; s++)
+		{
+			for (n = 0; benchSizes[n]; n++)
+			{
+				for (p = 0; benchPolicies[p] != NULL; p++, caseIndex++)
+				{
+					if (benchSizes[n] > BENCH_QUADRATIC_JOBS && is_quadratic(benchPolicies[p]))
+					{
+						continue;
+					}
+
+					BenchResult result;
+					snprintf(result.name, sizeof(result.name), "%s-%d-%s", benchShapes[s], benchSizes[n], benchPolicies[p]);
+					if (!measure_case(benchShapes[s], benchSizes[n], find_policy(benchPolicies[p]), &result))
+					{
+						printf("%-28s %12s %8s %10s  FAIL: crashed\n", result.name, "-", "-", "-");
+						failures++;
+						continue;
+					}
+
+					char overhead[64] = "";
+					if (strcmp(benchPolicies[p], BENCH_PLUGIN_BUILTIN) == 0)
+					{
+						builtinRate = result.jobsPerSecond;
+					}
+					else if (strcmp(benchPolicies[p], BENCH_PLUGIN_POLICY) == 0 && builtinRate > 0)
+					{
+						snprintf(overhead, sizeof(overhead), ", dispatch %+.1f%% vs %s", ((builtinRate / result.jobsPerSecond) - 1) * 100, BENCH_PLUGIN_BUILTIN);
+					}
+
+					if (update)
+					{
+						if (recorded[caseIndex].jobsPerSecond == 0 || result.jobsPerSecond < recorded[caseIndex].jobsPerSecond)
+						{
+							recorded[caseIndex] = result;
+						}
+						printf("%-28s %12.0f %8.4f %10ld  pass %d of %d%s\n", result.name, result.jobsPerSecond, result.spread, result.peakKb, pass + 1, passes, overhead);
+						fflush(stdout);
+						continue;
+					}
+
+					//A case that looks slower is timed again before it counts as a regression
+					char verdict[128];
+					BenchResult* base = find_baseline(baseline, baselineCount, result.name);
+					int passed = compare_case(&result, base, verdict, sizeof(verdict));
+					int retry;
+					for (retry = 0; !passed && base != NULL && retry < BENCH_RETRIES; retry++)
+					{
+						if (measure_case(benchShapes[s], benchSizes[n], find_policy(benchPolicies[p]), &result))
+						{
+							passed = compare_case(&result, base, verdict, sizeof(verdict));
+						}
+					} // end for
+					failures += !passed;
+					printf("%-28s %12.0f %8.4f %10ld  %s%s\n", result.name, result.jobsPerSecond, result.spread, result.peakKb, verdict, overhead);
+					fflush(stdout);
+				} // end for
+			} // end for
+		} // end for
+	} // end for
+
+	int c;
+	for (c = 0; update && c < caseCount; c++)
+	{
+		if (recorded[c].jobsPerSecond > 0)
+		{
+			fprintf(out, "%s\t%.0f\t%.4f\t%ld\t%.17g\t%.17g\t%.17g\n", recorded[c].name, recorded[c].jobsPerSecond, recorded[c].spread,
+					recorded[c].peakKb, recorded[c].responseTime, recorded[c].turnTime, recorded[c].waitTime);
+			printf("%-28s %12.0f %8.4f %10ld  stored\n", recorded[c].name, recorded[c].jobsPerSecond, recorded[c].spread, recorded[c].peakKb);
+		}
+	}
+	free(recorded);
+
+	if (out != NULL && fclose(out) != 0)
+	{
+		perror(path);
+		return 1;
+	}
+
+	free(baseline);
+	if (failures)
+	{
+		printf("%d case(s) regressed\n", failures);
+		return 1;
+	}
+	return 0;
+} // end main()
+
+int is_quadratic(char* name)
+{
+	int i;
+	for (i = 0; quadraticPolicies[i] != NULL; i++)
+	{
+		if (strcmp(quadraticPolicies[i], name) == 0)
+		{
+			return 1;
+		}
+	}
+
+	return 0;
+} // end function is_quadratic()
+
+int run_check(BenchCheck* check)
+{
+	//Load the jobs, then run them once with the case's quantum and tick
+	quiet = 1;
+	numProcesses = 0;
+	char* cursor = check->jobs;
+	long long arrival, burst;
+	int consumed;
+	while (sscanf(cursor, " %lld:%lld%n", &arrival, &burst, &consumed) == 2)
+	{
+		add_process((SimTime)arrival, (SimTime)burst);
+		cursor += consumed;
+	}
+	finish_workload();
+
+	SimTime savedQuantum = quantum;
+	SimTime savedTick = tickPeriod;
+	quantum = check->quantum;
+	tickPeriod = check->tick;
+	init_all();
+	if (tickPeriod > 0)
+	{
+		run_ticked(find_policy(check->policy));
+	}
+	else if (check->resume > 0)
+	{
+		//Stop at the checkpoint, then finish from the file with the settings back at their defaults
+		char path[64];
+		snprintf(path, sizeof(path), "/tmp/p5bench.%d.ck", (int)getpid());
+		checkpointPath = path;
+		checkpointInterval = check->resume;
+		stopTime = check->resume;
+		nextCheckpoint = processes.arrivalTime[0] + checkpointInterval;
+		find_policy(check->policy)->run();
+
+		checkpointInterval = 0;
+		stopTime = -1;
+		quantum = savedQuantum;
+		init_all();
+		read_checkpoint(path)->resume();
+		remove(path);
+		checkpointPath = NULL;
+	}
+	else
+	{
+		find_policy(check->policy)->run();
+	}
+	quantum = savedQuantum;
+	tickPeriod = savedTick;
+
+	int ok = same_metric(summary.responseTime, check->responseTime) && same_metric(summary.turnTime, check->turnTime)
+			&& same_metric(summary.waitTime, check->waitTime);
+	printf("%-28s %12s %8s %10s  ", check->name, "-", "-", "-");
+	if (ok)
+	{
+		printf("ok\n");
+	}
+	else
+	{
+		printf("FAIL: averages %.3f/%.3f/%.3f, worked out by hand as %.3f/%.3f/%.3f\n", summary.responseTime, summary.turnTime,
+				summary.waitTime, check->responseTime, check->turnTime, check->waitTime);
+	}
+	fflush(stdout);
+	return ok;
+} // end function run_check()
+
+int measure_case(char* shape, int jobs, Policy* policy, BenchResult* result)
+{
+	if (!run_case(shape, jobs, policy, result))
+	{
+		return 0;
+	}
+
+	//A noisy timing is taken again, so neither the baseline nor a check rests on a bad run
+	int retry;
+	for (retry = 0; retry < BENCH_RETRIES && result->spread > BENCH_NOISY; retry++)
+	{
+		BenchResult again = *result;
+		if (!run_case(shape, jobs, policy, &again))
+		{
+			return 0;
+		}
+		if (again.spread < result->spread)
+		{
+			*result = again;
+		}
+	} // end for
+
+	return 1;
+} // end function measure_case()
+
+int run_case(char* shape, int jobs, Policy* policy, BenchResult* result)
+{
+	int fds[2];
+	if (pipe(fds) != 0)
+	{
+		return 0;
+	}
+
+	//The child simulates and reports back over the pipe
+	pid_t child = fork();
+	if (child == 0)
+	{
+		close(fds[0]);
+		time_case(shape, jobs, policy, result);
+		ssize_t written = write(fds[1], result, sizeof(BenchResult));
+		_exit(written == sizeof(BenchResult) ? 0 : 1);
+	}
+	close(fds[1]);
+	if (child < 0)
+	{
+		close(fds[0]);
+		return 0;
+	}
+
+	//The parent keeps the name it chose and adds the child's peak memory
+	BenchResult reported;
+	ssize_t got = read(fds[0], &reported, sizeof(BenchResult));
+	close(fds[0]);
+
+	int status;
+	struct rusage usage;
+	if (wait4(child, &status, 0, &usage) != child || !WIFEXITED(status) || WEXITSTATUS(status) != 0 || got != sizeof(BenchResult))
+	{
+		return 0;
+	}
+
+	memcpy(reported.name, result->name, sizeof(reported.name));
+	*result = reported;
+	result->peakKb = usage.ru_maxrss;
+	return 1;
+} // end function run_case()
+
+void time_case(char* shape, int jobs, Policy* policy, BenchResult* result)
+{
+	quiet = 1;
+	generate_case(shape, jobs);
+
+	ProcessTable pristine = { 0 };
+	table_reserve(&pristine, processes.capacity);
+	table_copy(&pristine, &processes, numProcesses + 1);
+
+	//Repetitions from the same starting table until the budget is spent, so short cases
+	//get enough samples for the median to ride out noise; sorted afterwards for the median
+	double* seconds = malloc(sizeof(double) * BENCH_SAMPLES);
+	double total = 0;
+	int samples;
+	for (samples = 0; samples < BENCH_SAMPLES && (samples < BENCH_REPEATS || total < BENCH_BUDGET); samples++)
+	{
+		table_copy(&processes, &pristine, numProcesses + 1);
+		randomState = BENCH_SEED;
+		init_all();
+
+		struct timespec start, end;
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		policy->run();
+		clock_gettime(CLOCK_MONOTONIC, &end);
+
+		seconds[samples] = (end.tv_sec - start.tv_sec) + ((end.tv_nsec - start.tv_nsec) / 1e9);
+		total += seconds[samples];
+	} // end for
+	qsort(seconds, samples, sizeof(double), compare_seconds);
+	double median = seconds[samples / 2];
+
+	//Spread is the median absolute deviation over the median
+	int r;
+	for (r = 0; r < samples; r++)
+	{
+		seconds[r] = fabs(seconds[r] - median);
+	}
+	qsort(seconds, samples, sizeof(double), compare_seconds);
+
+	result->jobsPerSecond = jobs / ((median > 0) ? median : 1e-9);
+	result->spread = (median > 0) ? (seconds[samples / 2] / median) : 0;
+	result->responseTime = summary.responseTime;
+	result->turnTime = summary.turnTime;
+	result->waitTime = summary.waitTime;
+
+	free(seconds);
+	table_destructor(&pristine);
+} // end function time_case()
+
+void generate_case(char* shape, int jobs)
+{
+	//Same jobs every time: about 90% load, gaps averaging 10 and bursts 9
+	randomState = BENCH_SEED;
+	numProcesses = 0;
+	double arrival = 0;
+
+	int i;
+	for (i = 0; i < jobs; i++)
+	{
+		double burst;
+		int weight = 1;
+		if (strcmp(shape, "steady") == 0)
+		{
+			//Even gaps and bursts
+			arrival += 20 * bench_uniform();
+			burst = 1 + (16 * bench_uniform());
+		}
+		else if (strcmp(shape, "poisson") == 0)
+		{
+			//Poisson arrivals, exponential bursts
+			arrival += -10 * log(bench_uniform());
+			burst = -9 * log(bench_uniform());
+		}
+		else
+		{
+			//Poisson arrivals, Pareto bursts with alpha 1.5, and mixed weights
+			arrival += -10 * log(bench_uniform());
+			burst = 3 / pow(bench_uniform(), 1 / 1.5);
+			weight = 1 + (int)(8 * bench_uniform());
+		}
+
+		int pid = add_process((SimTime)arrival, (burst < 1) ? 1 : (SimTime)(burst + 0.5));
+		processes.weight[pid] = weight;
+	} // end for
+
+	finish_workload();
+} // end function generate_case()
+
+double bench_uniform()
+{
+	//Top 53 bits, strictly between 0 and 1
+	return ((next_random() >> 11) + 0.5) / 9007199254740992.0;
+} // end function bench_uniform()
+
+int compare_case(BenchResult* result, BenchResult* base, char* verdict, size_t size)
+{
+	if (base == NULL)
+	{
+		snprintf(verdict, size, "FAIL: not in the baseline");
+		return 0;
+	}
+
+	//Results are deterministic, so anything past rounding is drift
+	if (!same_metric(result->responseTime, base->responseTime) || !same_metric(result->turnTime, base->turnTime)
+			|| !same_metric(result->waitTime, base->waitTime))
+	{
+		snprintf(verdict, size, "FAIL: averages %.2f/%.2f/%.2f, expected %.2f/%.2f/%.2f", result->responseTime, result->turnTime,
+				result->waitTime, base->responseTime, base->turnTime, base->waitTime);
+		return 0;
+	}
+
+	//Slower than the noise in either run can explain, up to a point
+	double tolerance = BENCH_TOLERANCE;
+	double noise = 3 * (result->spread + base->spread);
+	tolerance = (noise > tolerance) ? noise : tolerance;
+	tolerance = (tolerance < BENCH_TOLERANCE_MAX) ? tolerance : BENCH_TOLERANCE_MAX;
+	double ratio = result->jobsPerSecond / base->jobsPerSecond;
+	if (ratio < 1 - tolerance)
+	{
+		snprintf(verdict, size, "FAIL: %.0f%% slower (allowed %.0f%%)", 100 * (1 - ratio), 100 * tolerance);
+		return 0;
+	}
+
+	if (result->peakKb > (base->peakKb * (1 + BENCH_MEMORY_TOLERANCE)) + BENCH_MEMORY_SLACK)
+	{
+		snprintf(verdict, size, "FAIL: peak memory %ld KB, baseline %ld KB", result->peakKb, base->peakKb);
+		return 0;
+	}
+
+	snprintf(verdict, size, "ok (%+.0f%%)", 100 * (ratio - 1));
+	return 1;
+} // end function compare_case()
+
+int same_metric(double value, double expected)
+{
+	return fabs(value - expected) <= 1e-9 * (fabs(expected) + 1);
+} // end function same_metric()
+
+int read_baseline(char* path, BenchResult** results)
+{
+	FILE* file = fopen(path, "r");
+	if (file == NULL)
+	{
+		return -1;
+	}
+
+	int count = 0;
+	int capacity = 0;
+	char line[512];
+	while (fgets(line, sizeof(line), file) != NULL)
+	{
+		if (count == capacity)
+		{
+			capacity = capacity ? capacity * 2 : 64;
+			*results = realloc(*results, sizeof(BenchResult) * capacity);
+		}
+
+		BenchResult* result = &(*results)[count];
+		if (sscanf(line, "%63s %lf %lf %ld %lf %lf %lf", result->name, &result->jobsPerSecond, &result->spread, &result->peakKb,
+				&result->responseTime, &result->turnTime, &result->waitTime) == 7 && result->name[0] != '#')
+		{
+			count++;
+		}
+	} // end while
+
+	fclose(file);
+	return count;
+} // end function read_baseline()
+
+BenchResult* find_baseline(BenchResult* results, int count, char* name)
+{
+	int i;
+	for (i = 0; i < count; i++)
+	{
+		if (strcmp(results[i].name, name) == 0)
+		{
+			return &results[i];
+		}
+	}
+
+	return NULL;
+} // end function find_baseline()
+
+int compare_seconds(const void* a, const void* b)
+{
+	double left = *(const double*)a;
+	double right = *(const double*)b;
+	return (left > right) - (left < right);
+} // end function compare_seconds()
@@ -0,0 +1,175 @@
+// ******************************************************************************************************************
+//  CPU Scheduler
+//  Copyright(C) 2018  James LoForti
+//  Contact Info: jamesloforti@gmail.com
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.If not, see<https://www.gnu.org/licenses/>.
+//									     ____.           .____             _____  _______   
+//									    |    |           |    |    ____   /  |  | \   _  \  
+//									    |    |   ______  |    |   /  _ \ /   |  |_/  /_\  \ 
+//									/\__|    |  /_____/  |    |__(  <_> )    ^   /\  \_/   \
+//									\________|           |_______ \____/\____   |  \_____  /
+//									                             \/          |__|        \/ 
+//
+// ******************************************************************************************************************
+//
+
+//Reference bounds for the workload, to say how far each policy is from the best it could do.
+//On one cpu, preemptive shortest remaining processing time (SRPT) gives the least total
+//turnaround of any schedule, and so the least total wait, so simulating it gives the optimum
+//rather than an estimate. Any schedule that never idles with work waiting ends at the same
+//time, so SRPT's end is also the least makespan. SRPT is run once, as the workload is loaded
+//and before any policy rewrites the bursts, with a heap keyed on remaining time: every job
+//is pushed and popped once, O(n log n)
+
+#include <stdlib.h> 
+#include <stdio.h> // needed for printf()
+#include "p5.h"
+
+//Bounds globals
+PER_THREAD int showGap; // follow the averages with their gap from the bounds
+PER_THREAD long double boundTurnTime; // mean turnaround under SRPT, in workload units
+PER_THREAD SimTime boundMakespan; // first arrival to last completion, idling only when nothing is ready
+PER_THREAD SimTime* srptRemaining; // the heap: remaining time and pid of each ready job
+PER_THREAD int* srptPid;
+PER_THREAD int srptCount;
+
+void compute_bounds()
+{
+	boundTurnTime = 0;
+	boundMakespan = 0;
+	if (!numProcesses)
+	{
+		return;
+	}
+
+	srptRemaining = malloc(sizeof(SimTime) * numProcesses);
+	srptPid = malloc(sizeof(int) * numProcesses);
+	srptCount = 0;
+
+	//Pids are in arrival order, so arrivals are taken in turn
+	long double sumTurnTime = 0;
+	SimTime clock = processes.arrivalTime[0];
+	int next = 0;
+	while (next < numProcesses || srptCount)
+	{
+		//Everything that has arrived is ready
+		while (next < numProcesses && processes.arrivalTime[next] <= clock)
+		{
+			srpt_push(processes.burstTime[next], next);
+			next++;
+		}
+
+		//Idle until the next arrival
+		if (!srptCount)
+		{
+			clock = processes.arrivalTime[next];
+			continue;
+		}
+
+		//Run the shortest until it ends or a new job arrives; shrinking the root keeps the heap in order
+		if (next < numProcesses && clock + srptRemaining[0] > processes.arrivalTime[next])
+		{
+			srptRemaining[0] -= processes.arrivalTime[next] - clock;
+			clock = processes.arrivalTime[next];
+		}
+		else
+		{
+			clock += srptRemaining[0];
+			sumTurnTime += clock - processes.arrivalTime[srptPid[0]];
+			srpt_pop();
+		}
+	} // end while
+
+	boundTurnTime = sumTurnTime / numProcesses;
+	boundMakespan = clock - processes.arrivalTime[0];
+
+	free(srptRemaining);
+	free(srptPid);
+	srptRemaining = NULL;
+	srptPid = NULL;
+} // end function compute_bounds()
+
+void srpt_push(SimTime remaining, int pid)
+{
+	//Sift up from the end
+	int i = srptCount++;
+	while (i > 0 && srpt_less(remaining, pid, srptRemaining[(i - 1) / 2], srptPid[(i - 1) / 2]))
+	{
+		srptRemaining[i] = srptRemaining[(i - 1) / 2];
+		srptPid[i] = srptPid[(i - 1) / 2];
+		i = (i - 1) / 2;
+	}
+	srptRemaining[i] = remaining;
+	srptPid[i] = pid;
+} // end function srpt_push()
+
+void srpt_pop()
+{
+	//Sift the last entry down from the root
+	srptCount--;
+	SimTime remaining = srptRemaining[srptCount];
+	int pid = srptPid[srptCount];
+	int i = 0;
+	while ((2 * i) + 1 < srptCount)
+	{
+		//The lesser child
+		int child = (2 * i) + 1;
+		if (child + 1 < srptCount && srpt_less(srptRemaining[child + 1], srptPid[child + 1], srptRemaining[child], srptPid[child]))
+		{
+			child++;
+		}
+
+		if (!srpt_less(srptRemaining[child], srptPid[child], remaining, pid))
+		{
+			break;
+		}
+		srptRemaining[i] = srptRemaining[child];
+		srptPid[i] = srptPid[child];
+		i = child;
+	} // end while
+	srptRemaining[i] = remaining;
+	srptPid[i] = pid;
+} // end function srpt_pop()
+
+int srpt_less(SimTime remaining, int pid, SimTime otherRemaining, int otherPid)
+{
+	//Shortest remaining first, earliest arrival breaking ties
+	if (remaining != otherRemaining)
+	{
+		return remaining < otherRemaining;
+	}
+	return pid < otherPid;
+} // end function srpt_less()
+
+void print_gap()
+{
+	//Label times with their unit, when the workload declared one
+	char* unit = (outputUnit != NULL) ? outputUnit->name : "";
+	char* space = (outputUnit != NULL) ? " " : "";
+
+	//The policy's makespan, from the first arrival
+	SimTime lastEnd = processes.arrivalTime[0];
+	int i;
+	for (i = 0; i < numProcesses; i++)
+	{
+		lastEnd = (processes.endTime[i] > lastEnd) ? processes.endTime[i] : lastEnd;
+	}
+	SimTime makespan = lastEnd - processes.arrivalTime[0];
+
+	double bestTurnTime = to_output_unit((double)boundTurnTime);
+	printf("	Optimality Gap: %+.1f%% turnaround over SRPT's %.2f%s%s, %+.1f%% makespan over %.2f%s%s\n",
+			bestTurnTime ? (100 * (summary.turnTime - bestTurnTime) / bestTurnTime) : 0, bestTurnTime, space, unit,
+			boundMakespan ? (100.0 * (makespan - boundMakespan) / boundMakespan) : 0, to_output_unit(boundMakespan), space, unit);
+} // end function print_gap()
@@ -0,0 +1,164 @@
+// ******************************************************************************************************************
+//  CPU Scheduler
+//  Copyright(C) 2018  James LoForti
+//  Contact Info: jamesloforti@gmail.com
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.If not, see<https://www.gnu.org/licenses/>.
+//									     ____.           .____             _____  _______   
+//									    |    |           |    |    ____   /  |  | \   _  \  
+//									    |    |   ______  |    |   /  _ \ /   |  |_/  /_\  \ 
+//									/\__|    |  /_____/  |    |__(  <_> )    ^   /\  \_/   \
+//									\________|           |_______ \____/\____   |  \_____  /
+//									                             \/          |__|        \/ 
+//
+// ******************************************************************************************************************
+//
+
+//Result cache: a directory of finished reports, one file per workload and policy setting.
+//Reruns of an unchanged workload print the stored report instead of simulating again.
+//Files are named by a hash of the workload fingerprint, the policy and every knob it reads
+
+#include <stdlib.h> 
+#include <stdio.h> // needed for open_memstream()
+#include <string.h> // needed for strlen()
+#include <unistd.h> // needed for getpid()
+#include "p5.h"
+
+void run_cached(Policy* policy, char* directory)
+{
+	char path[4096];
+	snprintf(path, sizeof(path), "%s/%016llx", directory, cache_key(policy));
+
+	//Hit: print what the last run printed
+	if (replay_cached(path))
+	{
+		return;
+	}
+
+	//Miss: capture the report while simulating (glibc lets stdout be reassigned)
+	char* report = NULL;
+	size_t length = 0;
+	FILE* console = stdout;
+	fflush(console);
+	stdout = open_memstream(&report, &length);
+	if (stdout == NULL)
+	{
+		stdout = console;
+		policy->run();
+		return;
+	}
+
+	policy->run();
+
+	fclose(stdout);
+	stdout = console;
+	fwrite(report, 1, length, stdout);
+
+	store_cached(path, report, length);
+	free(report);
+} // end function run_cached()
+
+unsigned long long cache_key(Policy* policy)
+{
+	//Only the knobs the policy reads go in, so fcfs hits whatever the quantum
+	unsigned long long values[15] = { CACHE_VERSION, workloadFingerprint, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+	if (policy->uses & USES_QUANTUM)
+	{
+		values[2] = (unsigned long long)quantum;
+	}
+	if (policy->uses & USES_SEED)
+	{
+		values[3] = randomState;
+	}
+	if (policy->uses & USES_INTERVAL)
+	{
+		values[4] = (unsigned long long)shareInterval;
+	}
+	if (policy->uses & USES_QUEUE)
+	{
+		values[7] = (unsigned long long)queueCapacity;
+		values[8] = (unsigned long long)admission[0]; // the policies differ in their first letter
+	}
+	if (policy->uses & USES_PREDICTION)
+	{
+		memcpy(&values[9], &predictAlpha, sizeof(double));
+		values[10] = (unsigned long long)predictInitial;
+	}
+	if (policy->uses & USES_ADAPTIVE)
+	{
+		values[11] = (unsigned long long)adaptiveMin;
+		values[12] = (unsigned long long)adaptiveMax;
+		values[13] = (unsigned long long)adaptiveLatency;
+	}
+
+	//The report is printed in the output unit, converted from the workload's, with or without the spread and the gap
+	values[5] = (outputUnit != NULL) ? (unsigned long long)outputUnit->nanoseconds : 0;
+	values[6] = (unsigned long long)(showSpread | (showGap << 1));
+	values[14] = (inputUnit != NULL) ? (unsigned long long)inputUnit->nanoseconds : 0;
+
+	//FNV-1a over the values, then the policy name
+	unsigned long long hash = 14695981039346656037ULL;
+	unsigned char* bytes = (unsigned char*)values;
+	size_t b;
+	for (b = 0; b < sizeof(values); b++)
+	{
+		hash ^= bytes[b];
+		hash *= 1099511628211ULL;
+	}
+	for (b = 0; b < strlen(policy->name); b++)
+	{
+		hash ^= (unsigned char)policy->name[b];
+		hash *= 1099511628211ULL;
+	}
+
+	return hash;
+} // end function cache_key()
+
+int replay_cached(char* path)
+{
+	FILE* file = fopen(path, "rb");
+	if (file == NULL)
+	{
+		return 0;
+	}
+
+	char buffer[4096];
+	size_t length;
+	while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0)
+	{
+		fwrite(buffer, 1, length, stdout);
+	}
+
+	fclose(file);
+	return 1;
+} // end function replay_cached()
+
+void store_cached(char* path, char* report, size_t length)
+{
+	//Write to a scratch file first, so a concurrent run never replays half a report
+	char scratch[4200];
+	snprintf(scratch, sizeof(scratch), "%s.%d.tmp", path, (int)getpid());
+	FILE* file = fopen(scratch, "wb");
+	if (file == NULL)
+	{
+		//A cache that can't be written only costs speed
+		return;
+	}
+
+	int ok = (fwrite(report, 1, length, file) == length);
+	if (fclose(file) != 0 || !ok || rename(scratch, path) != 0)
+	{
+		remove(scratch);
+	}
+} // end function store_cached()
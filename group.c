@@ -0,0 +1,563 @@
+// ******************************************************************************************************************
+//  CPU Scheduler
+//  Copyright(C) 2018  James LoForti
+//  Contact Info: jamesloforti@gmail.com
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.If not, see<https://www.gnu.org/licenses/>.
+//									     ____.           .____             _____  _______   
+//									    |    |           |    |    ____   /  |  | \   _  \  
+//									    |    |   ______  |    |   /  _ \ /   |  |_/  /_\  \ 
+//									/\__|    |  /_____/  |    |__(  <_> )    ^   /\  \_/   \
+//									\________|           |_______ \____/\____   |  \_____  /
+//									                             \/          |__|        \/ 
+//
+// ******************************************************************************************************************
+//
+
+//Hierarchical fair share: processes belong to groups named by path (/tenant/service), and
+//the cpu is shared by stride scheduling at every level of the tree, first between sibling
+//groups by their weights, then between the jobs inside a group by theirs. A group may also
+//be capped to a quota of cpu time per period, like cgroup cpu.max; a capped group that has
+//used its quota sits out until its period ends. Groups come from workload lines like:
+//	group /tenantA weight=3 max=50000/100000
+
+#include <stdlib.h> 
+#include <stdio.h> // needed for printf()
+#include <string.h> // needed for strcmp()
+#include <inttypes.h> // needed for PRId64
+#include "p5.h"
+
+//Group globals
+PER_THREAD Group* groups; // 0 is the root, "/"
+PER_THREAD int groupCount;
+PER_THREAD int groupCapacity;
+PER_THREAD int* groupIndex; // open addressed on path, -1 for a free slot
+PER_THREAD int groupIndexSize;
+PER_THREAD int* throttledGroups; // groups sitting out the rest of their period
+PER_THREAD int throttledCount;
+const P5Policy groupPolicy = { P5_POLICY_ABI, "group", NULL, join_group, pick_group, requeue_group, leave_group, NULL };
+
+int read_group(char* line)
+{
+	//group PATH [weight=N] [max=QUOTA/PERIOD]
+	char path[4096];
+	int consumed;
+	if (sscanf(line, " group %4095s%n", path, &consumed) != 1)
+	{
+		return 0;
+	}
+
+	int g = find_group(path, 1);
+	if (g < 0)
+	{
+		fprintf(stderr, "group '%s': paths start with /\n", path);
+		exit(1);
+	}
+
+	char* token;
+	for (token = strtok(line + consumed, " \t\r\n"); token != NULL; token = strtok(NULL, " \t\r\n"))
+	{
+		if (strncmp(token, "weight=", 7) == 0)
+		{
+			groups[g].weight = atoi(token + 7);
+			if (groups[g].weight <= 0)
+			{
+				fprintf(stderr, "group '%s': weight must be positive\n", path);
+				exit(1);
+			}
+		}
+		else if (strncmp(token, "max=", 4) == 0)
+		{
+			if (sscanf(token + 4, "%" SCNd64 "/%" SCNd64, &groups[g].quota, &groups[g].period) != 2
+				|| groups[g].quota <= 0 || groups[g].period < groups[g].quota || g == 0)
+			{
+				fprintf(stderr, "group '%s': max takes quota/period, with 0 < quota <= period, and the root can't be capped\n", path);
+				exit(1);
+			}
+		}
+		else
+		{
+			fprintf(stderr, "group '%s': unknown attribute '%s'\n", path, token);
+			exit(1);
+		}
+	} // end for
+
+	return 1;
+} // end function read_group()
+
+int find_group(char* path, int create)
+{
+	//Paths are absolute, with no trailing slash except the root's
+	if (path[0] != '/')
+	{
+		return -1;
+	}
+	size_t length = strlen(path);
+	while (length > 1 && path[length - 1] == '/')
+	{
+		length--;
+	}
+
+	if (!groupCount)
+	{
+		add_group("/", 1, -1);
+	}
+	if (length == 1)
+	{
+		return 0;
+	}
+
+	//Linear probe from the path's home slot
+	unsigned slot = hash_path(path, length) & (unsigned)(groupIndexSize - 1);
+	while (groupIndex[slot] >= 0)
+	{
+		char* other = groups[groupIndex[slot]].path;
+		if (strlen(other) == length && strncmp(other, path, length) == 0)
+		{
+			return groupIndex[slot];
+		}
+		slot = (slot + 1) & (unsigned)(groupIndexSize - 1);
+	}
+
+	if (!create)
+	{
+		return -1;
+	}
+
+	//Parents first, so every group hangs off the tree
+	size_t cut = length - 1;
+	while (cut > 0 && path[cut] != '/')
+	{
+		cut--;
+	}
+	char* parentPath = strndup(path, cut ? cut : 1);
+	int parent = find_group(parentPath, 1);
+	free(parentPath);
+
+	return add_group(path, (int)length, parent);
+} // end function find_group()
+
+int add_group(char* path, int length, int parent)
+{
+	if (groupCount == groupCapacity)
+	{
+		groupCapacity = groupCapacity ? (groupCapacity * 2) : 16;
+		groups = realloc(groups, sizeof(Group) * groupCapacity);
+	}
+
+	int g = groupCount++;
+	memset(&groups[g], 0, sizeof(Group));
+	groups[g].path = strndup(path, length);
+	groups[g].parent = parent;
+	groups[g].weight = 1;
+
+	//Keep the index at most half full
+	if (groupCount * 2 > groupIndexSize)
+	{
+		groupIndexSize = groupIndexSize ? (groupIndexSize * 2) : 64;
+		groupIndex = realloc(groupIndex, sizeof(int) * groupIndexSize);
+		memset(groupIndex, -1, sizeof(int) * groupIndexSize);
+
+		int i;
+		for (i = 1; i < groupCount; i++)
+		{
+			index_group(i);
+		}
+	}
+	else if (g > 0)
+	{
+		index_group(g);
+	}
+
+	return g;
+} // end function add_group()
+
+void index_group(int g)
+{
+	unsigned slot = hash_path(groups[g].path, strlen(groups[g].path)) & (unsigned)(groupIndexSize - 1);
+	while (groupIndex[slot] >= 0)
+	{
+		slot = (slot + 1) & (unsigned)(groupIndexSize - 1);
+	}
+	groupIndex[slot] = g;
+} // end function index_group()
+
+unsigned hash_path(char* path, size_t length)
+{
+	//FNV-1a
+	unsigned hash = 2166136261u;
+	size_t i;
+	for (i = 0; i < length; i++)
+	{
+		hash ^= (unsigned char)path[i];
+		hash *= 16777619u;
+	}
+
+	return hash;
+} // end function hash_path()
+
+unsigned long long fingerprint_groups(unsigned long long hash)
+{
+	//Weights and caps change the schedule as much as the jobs do
+	int g;
+	for (g = 0; g < groupCount; g++)
+	{
+		long long values[3] = { groups[g].weight, groups[g].quota, groups[g].period };
+		unsigned char* bytes = (unsigned char*)values;
+
+		size_t b;
+		for (b = 0; b < sizeof(values); b++)
+		{
+			hash ^= bytes[b];
+			hash *= 1099511628211ULL;
+		}
+	} // end for
+
+	return hash;
+} // end function fingerprint_groups()
+
+//***************************************************************************GROUP FAIR SHARE
+
+void group_fair()
+{
+	//Ungrouped workloads run everything in the root
+	if (!groupCount)
+	{
+		add_group("/", 1, -1);
+	}
+
+	reserve_share(numProcesses);
+	throttledGroups = realloc(throttledGroups, sizeof(int) * groupCount);
+	throttledCount = 0;
+
+	int g;
+	for (g = 0; g < groupCount; g++)
+	{
+		Group* group = &groups[g];
+		group->heapCount = 0;
+		group->pass = 0;
+		group->lastPass = 0;
+		group->usage = 0;
+		group->periodEnd = group->period ? (((processes.arrivalTime[0] / group->period) + 1) * group->period) : 0;
+		group->queued = 0;
+		group->onPath = 0;
+		group->throttled = 0;
+		group->service = 0;
+	} // end for
+
+	char label[64];
+	snprintf(label, sizeof(label), "Group Fair Share (w/ quantum %" PRId64 ")", quantum);
+	run_share(label, &groupPolicy);
+
+	if (!quiet)
+	{
+		print_groups();
+	}
+} // end function group_fair()
+
+void join_group(void* state, int pid, const P5PolicyJob* job)
+{
+	//Newcomers start level with whatever their group ran last
+	int g = processes.group[pid];
+	pass[pid] = groups[g].lastPass;
+	group_push(g, pid);
+	group_activate(g);
+} // end function join_group()
+
+int pick_group(void* state, int64_t now, int64_t* slice)
+{
+	//Groups whose period is over get their quota back
+	release_groups();
+
+	//Everything runnable is capped out: idle until the first period ends
+	if (!groups[0].heapCount)
+	{
+		SimTime idleUntil = INT64_MAX;
+		int i;
+		for (i = 0; i < throttledCount; i++)
+		{
+			if (groups[throttledGroups[i]].periodEnd < idleUntil)
+			{
+				idleUntil = groups[throttledGroups[i]].periodEnd;
+			}
+		}
+		*slice = idleUntil - now;
+		return -1;
+	}
+
+	//Take the lowest pass at every level on the way down
+	int g = 0;
+	while (1)
+	{
+		int entry = group_pop(g);
+		if (entry >= 0)
+		{
+			groups[g].lastPass = pass[entry];
+			return entry;
+		}
+
+		int child = -(entry + 1);
+		groups[g].lastPass = groups[child].pass;
+		groups[child].queued = 0;
+		groups[child].onPath = 1;
+
+		//A capped group can't run past its remaining quota
+		if (groups[child].quota)
+		{
+			roll_period(child);
+			SimTime left = groups[child].quota - groups[child].usage;
+			*slice = (left < *slice) ? left : *slice;
+		}
+
+		g = child;
+	} // end while
+} // end function pick_group()
+
+void requeue_group(void* state, int pid, int64_t ran)
+{
+	//Back into its group, advanced in proportion to the slice used, then charge the groups above
+	int g = processes.group[pid];
+	pass[pid] += ((long long)(STRIDE1 / processes.weight[pid]) * ran) / quantum;
+	group_push(g, pid);
+	charge_groups(g, ran);
+} // end function requeue_group()
+
+void leave_group(void* state, int pid, int64_t ran)
+{
+	//The final slice still counts against the groups above
+	charge_groups(processes.group[pid], ran);
+} // end function leave_group()
+
+void charge_groups(int g, SimTime ran)
+{
+	groups[g].service += ran;
+
+	//Bottom up along the path just run, putting each group back in line if it still has work
+	while (groups[g].parent >= 0)
+	{
+		Group* group = &groups[g];
+		group->onPath = 0;
+		group->pass += ((long long)(STRIDE1 / group->weight) * ran) / quantum;
+
+		if (group->quota)
+		{
+			roll_period(g);
+			group->usage += ran;
+			if (group->usage >= group->quota)
+			{
+				group->throttled = 1;
+				throttledGroups[throttledCount++] = g;
+			}
+		}
+
+		if (!group->throttled && group->heapCount)
+		{
+			group_push(group->parent, -(g + 1));
+			group->queued = 1;
+		}
+
+		g = group->parent;
+	} // end while
+} // end function charge_groups()
+
+void roll_period(int g)
+{
+	//A slice is charged to the period it ends in
+	Group* group = &groups[g];
+	if (simClock >= group->periodEnd)
+	{
+		group->usage = 0;
+		group->periodEnd = ((simClock / group->period) + 1) * group->period;
+	}
+} // end function roll_period()
+
+void release_groups()
+{
+	int i = 0;
+	while (i < throttledCount)
+	{
+		int g = throttledGroups[i];
+		if (groups[g].periodEnd > simClock)
+		{
+			i++;
+			continue;
+		}
+
+		//Swap the last throttled group into this slot, then rejoin the tree
+		throttledGroups[i] = throttledGroups[--throttledCount];
+		groups[g].throttled = 0;
+		roll_period(g);
+		group_activate(g);
+	} // end while
+} // end function release_groups()
+
+void group_activate(int g)
+{
+	//Walk up, queueing each group that now has work, until one is already in line or running
+	while (groups[g].parent >= 0 && !groups[g].queued && !groups[g].onPath && !groups[g].throttled && groups[g].heapCount)
+	{
+		//Groups coming back start level with their siblings, so idling banks no credit
+		Group* parent = &groups[groups[g].parent];
+		if (groups[g].pass < parent->lastPass)
+		{
+			groups[g].pass = parent->lastPass;
+		}
+
+		group_push(groups[g].parent, -(g + 1));
+		groups[g].queued = 1;
+		g = groups[g].parent;
+	} // end while
+} // end function group_activate()
+
+long long entry_pass(int entry)
+{
+	//Jobs are stored as pids, child groups as -(group + 1)
+	return (entry >= 0) ? pass[entry] : groups[-(entry + 1)].pass;
+} // end function entry_pass()
+
+int entry_less(int a, int b)
+{
+	//Order by pass, then by entry so ties break deterministically
+	long long passA = entry_pass(a);
+	long long passB = entry_pass(b);
+	if (passA != passB)
+	{
+		return passA < passB;
+	}
+	return a < b;
+} // end function entry_less()
+
+void group_push(int g, int entry)
+{
+	Group* group = &groups[g];
+	if (group->heapCount == group->heapCapacity)
+	{
+		group->heapCapacity = group->heapCapacity ? (group->heapCapacity * 2) : 8;
+		group->heap = realloc(group->heap, sizeof(int) * group->heapCapacity);
+	}
+
+	//Sift the new entry up from the bottom
+	int i = group->heapCount++;
+	while (i > 0 && entry_less(entry, group->heap[(i - 1) / 2]))
+	{
+		group->heap[i] = group->heap[(i - 1) / 2];
+		i = (i - 1) / 2;
+	}
+	group->heap[i] = entry;
+} // end function group_push()
+
+int group_pop(int g)
+{
+	Group* group = &groups[g];
+	int top = group->heap[0];
+	int last = group->heap[--group->heapCount];
+
+	//Sift the last entry down from the top
+	int i = 0;
+	while ((2 * i) + 1 < group->heapCount)
+	{
+		int child = (2 * i) + 1;
+		if (child + 1 < group->heapCount && entry_less(group->heap[child + 1], group->heap[child]))
+		{
+			child++;
+		}
+
+		if (!entry_less(group->heap[child], last))
+		{
+			break;
+		}
+
+		group->heap[i] = group->heap[child];
+		i = child;
+	} // end while
+	group->heap[i] = last;
+
+	return top;
+} // end function group_pop()
+
+void print_groups()
+{
+	//Bucket pids by group, in arrival order within each
+	int* start = calloc(groupCount + 1, sizeof(int));
+	int* order = malloc(sizeof(int) * numProcesses);
+	SimTime* turnTimes = malloc(sizeof(SimTime) * numProcesses);
+	int i;
+	for (i = 0; i < numProcesses; i++)
+	{
+		start[processes.group[i] + 1]++;
+	}
+	int g;
+	for (g = 0; g < groupCount; g++)
+	{
+		start[g + 1] += start[g];
+	}
+	int* fill = malloc(sizeof(int) * groupCount);
+	memcpy(fill, start, sizeof(int) * groupCount);
+	for (i = 0; i < numProcesses; i++)
+	{
+		order[fill[processes.group[i]]++] = i;
+	}
+
+	//Label times with their unit, when the workload declared one
+	char* unit = (outputUnit != NULL) ? outputUnit->name : "";
+	char* space = (outputUnit != NULL) ? " " : "";
+
+	SimTime totalService = 0;
+	for (g = 0; g < groupCount; g++)
+	{
+		totalService += groups[g].service;
+	}
+
+	printf("\tGroups (path, weight, jobs, cpu share, jobs per 1000%s%s, AVG turnaround, p99 turnaround):\n", space, unit);
+	for (g = 0; g < groupCount; g++)
+	{
+		int count = start[g + 1] - start[g];
+		if (!count)
+		{
+			continue;
+		}
+
+		//Turnaround times of the group's jobs, and the span they were in the system
+		long double sumTurnTime = 0;
+		SimTime first = processes.arrivalTime[order[start[g]]];
+		SimTime last = first;
+		for (i = 0; i < count; i++)
+		{
+			int pid = order[start[g] + i];
+			turnTimes[i] = processes.endTime[pid] - processes.arrivalTime[pid];
+			sumTurnTime += turnTimes[i];
+			last = (processes.endTime[pid] > last) ? processes.endTime[pid] : last;
+		}
+		qsort(turnTimes, count, sizeof(SimTime), compare_times);
+
+		double span = to_output_unit((double)(last - first));
+		printf("\t\t%s\t%d\t%d\t%.2f%%\t%.2f\t%.2f%s%s\t%.2f%s%s\n", groups[g].path, groups[g].weight, count,
+				totalService ? (100.0 * groups[g].service / totalService) : 0,
+				span > 0 ? (1000.0 * count / span) : 0,
+				to_output_unit((double)(sumTurnTime / count)), space, unit,
+				to_output_unit((double)turnTimes[(int)((((long long)count * 99) + 99) / 100) - 1]), space, unit);
+	} // end for
+
+	free(start);
+	free(order);
+	free(turnTimes);
+	free(fill);
+} // end function print_groups()
+
+int compare_times(const void* a, const void* b)
+{
+	SimTime left = *(const SimTime*)a;
+	SimTime right = *(const SimTime*)b;
+	return (left > right) - (left < right);
+} // end function compare_times()
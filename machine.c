@@ -0,0 +1,524 @@
+// ******************************************************************************************************************
+//  CPU Scheduler
+//  Copyright(C) 2018  James LoForti
+//  Contact Info: jamesloforti@gmail.com
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.If not, see<https://www.gnu.org/licenses/>.
+//									     ____.           .____             _____  _______   
+//									    |    |           |    |    ____   /  |  | \   _  \  
+//									    |    |   ______  |    |   /  _ \ /   |  |_/  /_\  \ 
+//									/\__|    |  /_____/  |    |__(  <_> )    ^   /\  \_/   \
+//									\________|           |_______ \____/\____   |  \_____  /
+//									                             \/          |__|        \/ 
+//
+// ******************************************************************************************************************
+//
+
+//Machine model: several cores, each retiring burst at its own speed, optionally stepping
+//through DVFS speeds as the backlog grows. A global run queue feeds idle cores in fcfs,
+//sjf or srtf order, and a placement rule picks which idle core a job lands on, within the
+//job's affinity mask. Cores sit in last level cache domains inside NUMA nodes, and a job
+//resuming on another core pays extra work by how far it moved.
+//Burst is tracked as fixed point work so fractional speeds add up exactly
+
+#include <stdlib.h> 
+#include <stdio.h> // needed for printf()
+#include <string.h> // needed for strcmp()
+#include <inttypes.h> // needed for PRId64
+#include "p5.h"
+
+//Machine globals
+PER_THREAD Core cores[MAX_CORES];
+PER_THREAD int coreCount; // 0 runs the classic single CPU engine
+PER_THREAD char* placement = "first"; // first, fastest, short or near
+PER_THREAD int topologyGiven;
+PER_THREAD SimTime migrationCost[3]; // work added for a move to another core in the same llc, another llc, another node
+PER_THREAD int migrations[3]; // moves at each of those levels in the last run
+PER_THREAD int* lastCore; // core each pid last ran on, -1 before its first dispatch
+PER_THREAD int* skipped; // queued pids set aside while looking for one that fits an idle core
+PER_THREAD long long* work; // fixed point burst still to retire, per pid
+PER_THREAD long long shortWork; // jobs at or under the mean burst count as short
+
+int parse_machine(char* text)
+{
+	//Cores separated by commas, each a speed or DVFS steps fastest first: 2:1.5:1,1
+	coreCount = 0;
+	char* cursor = text;
+	while (*cursor && coreCount < MAX_CORES)
+	{
+		Core* core = &cores[coreCount++];
+		memset(core, 0, sizeof(Core));
+
+		char* end;
+		do
+		{
+			double speed = strtod(cursor, &end);
+			if (end == cursor || speed <= 0 || core->stepCount == MAX_STEPS)
+			{
+				return 0;
+			}
+
+			core->steps[core->stepCount++] = speed;
+			cursor = (*end == ':') ? (end + 1) : end;
+		} while (*end == ':');
+
+		if (*end != ',' && *end != '\0')
+		{
+			return 0;
+		}
+		cursor = (*end == ',') ? (end + 1) : end;
+	} // end while
+
+	//Until told otherwise every core shares one cache and one node
+	int c;
+	for (c = 0; c < coreCount; c++)
+	{
+		cores[c].llc = 0;
+		cores[c].node = 0;
+	}
+
+	return (coreCount > 0 && *cursor == '\0');
+} // end function parse_machine()
+
+int parse_topology(char* text)
+{
+	//nodes[,llcs per node], splitting the cores evenly in order
+	char* end;
+	long nodes = strtol(text, &end, 10);
+	long llcs = 1;
+	if (*end == ',')
+	{
+		llcs = strtol(end + 1, &end, 10);
+	}
+	if (*end != '\0' || nodes <= 0 || llcs <= 0 || coreCount % (nodes * llcs) != 0)
+	{
+		return 0;
+	}
+
+	int perLlc = coreCount / (int)(nodes * llcs);
+	int c;
+	for (c = 0; c < coreCount; c++)
+	{
+		cores[c].llc = c / perLlc;
+		cores[c].node = cores[c].llc / (int)llcs;
+	}
+
+	topologyGiven = 1;
+	return 1;
+} // end function parse_topology()
+
+int parse_migration_costs(char* text)
+{
+	//Costs for moving within an llc, across llcs, across nodes; missing ones repeat the last
+	char* cursor = text;
+	int level;
+	for (level = 0; level < 3; level++)
+	{
+		char* end;
+		migrationCost[level] = strtoll(cursor, &end, 10);
+		if (end == cursor || migrationCost[level] < 0)
+		{
+			return 0;
+		}
+
+		if (*end == '\0')
+		{
+			for (level++; level < 3; level++)
+			{
+				migrationCost[level] = migrationCost[level - 1];
+			}
+			return 1;
+		}
+		if (*end != ',')
+		{
+			return 0;
+		}
+		cursor = end + 1;
+	} // end for
+
+	return (*cursor == '\0');
+} // end function parse_migration_costs()
+
+int parse_cpu_list(char* text, uint64_t* mask)
+{
+	//Core numbers and ranges: 0-3,8
+	*mask = 0;
+	char* cursor = text;
+	while (*cursor)
+	{
+		char* end;
+		long low = strtol(cursor, &end, 10);
+		long high = low;
+		if (end == cursor)
+		{
+			return 0;
+		}
+		if (*end == '-')
+		{
+			cursor = end + 1;
+			high = strtol(cursor, &end, 10);
+			if (end == cursor)
+			{
+				return 0;
+			}
+		}
+		if (low < 0 || high < low || high >= MAX_CORES || (*end != ',' && *end != '\0'))
+		{
+			return 0;
+		}
+
+		long core;
+		for (core = low; core <= high; core++)
+		{
+			*mask |= 1ULL << core;
+		}
+		cursor = (*end == ',') ? (end + 1) : end;
+	} // end while
+
+	return (*mask != 0);
+} // end function parse_cpu_list()
+
+int machine_supports(char* name)
+{
+	return (!strcmp(name, "fcfs") || !strcmp(name, "sjf") || !strcmp(name, "srtf"));
+} // end function machine_supports()
+
+int check_affinity()
+{
+	//Every job needs at least one core of this machine to run on, returns the first that hasn't
+	uint64_t machineMask = (coreCount == MAX_CORES) ? ~0ULL : ((1ULL << coreCount) - 1);
+	int i;
+	for (i = 0; i < numProcesses; i++)
+	{
+		if (processes.affinity[i] && !(processes.affinity[i] & machineMask))
+		{
+			return i;
+		}
+	}
+
+	return -1;
+} // end function check_affinity()
+
+int core_distance(Core* a, Core* b)
+{
+	//0: same core, 1: same llc, 2: same node, 3: another node
+	if (a == b)
+	{
+		return 0;
+	}
+	if (a->llc == b->llc)
+	{
+		return 1;
+	}
+	return (a->node == b->node) ? 2 : 3;
+} // end function core_distance()
+
+void run_machine(Policy* policy)
+{
+	//Queue order: arrival for fcfs, remaining work otherwise; only srtf preempts
+	int byWork = strcmp(policy->name, "fcfs") != 0;
+	int preemptive = !strcmp(policy->name, "srtf");
+
+	//The stride heap orders on pass, so pass holds the queue key here
+	reserve_share(numProcesses);
+	heapCount = 0;
+	work = realloc(work, sizeof(long long) * numProcesses);
+	lastCore = realloc(lastCore, sizeof(int) * numProcesses);
+	skipped = realloc(skipped, sizeof(int) * numProcesses);
+	memset(migrations, 0, sizeof(migrations));
+
+	long double totalWork = 0;
+	int i;
+	for (i = 0; i < numProcesses; i++)
+	{
+		work[i] = processes.burstTime[i] * WORK_SCALE;
+		totalWork += work[i];
+		lastCore[i] = -1;
+	}
+	shortWork = (long long)(totalWork / numProcesses);
+
+	int c;
+	for (c = 0; c < coreCount; c++)
+	{
+		cores[c].job = -1;
+		cores[c].busyTime = 0;
+		cores[c].jobsRun = 0;
+	}
+
+	//Event loop: admit arrivals, preempt, dispatch, then run every core to the next event
+	simClock = processes.arrivalTime[0];
+	int nextArrival = 0;
+	int finished = 0;
+	while (finished < numProcesses)
+	{
+		while (nextArrival < numProcesses && processes.arrivalTime[nextArrival] <= simClock)
+		{
+			pass[nextArrival] = byWork ? work[nextArrival] : nextArrival;
+			processes.beginWaiting[nextArrival] = simClock;
+			heap_push(nextArrival++);
+		}
+
+		if (preemptive)
+		{
+			preempt_machine();
+		}
+		dispatch_machine();
+		set_core_speeds();
+
+		//Next event: an arrival, or the first core to finish its job
+		SimTime next = (nextArrival < numProcesses) ? processes.arrivalTime[nextArrival] : INT64_MAX;
+		for (c = 0; c < coreCount; c++)
+		{
+			if (cores[c].job >= 0 && core_finish_time(&cores[c]) < next)
+			{
+				next = core_finish_time(&cores[c]);
+			}
+		}
+
+		//Retire work up to then
+		for (c = 0; c < coreCount; c++)
+		{
+			Core* core = &cores[c];
+			if (core->job < 0)
+			{
+				continue;
+			}
+
+			core->busyTime += next - simClock;
+			if (core_finish_time(core) == next)
+			{
+				work[core->job] = 0;
+				processes.endTime[core->job] = next;
+				core->job = -1;
+				finished++;
+			}
+			else
+			{
+				work[core->job] -= (long long)((next - simClock) * core->speed * WORK_SCALE);
+			}
+		} // end for
+
+		simClock = next;
+	} // end while
+
+	//Calculate avg times and print to console, then how each core was used
+	char label[128];
+	snprintf(label, sizeof(label), "%s (%d cores, %s placement)", machine_label(policy), coreCount, placement);
+	calc_times_and_print(label);
+
+	if (!quiet)
+	{
+		print_cores();
+	}
+} // end function run_machine()
+
+void preempt_machine()
+{
+	//While the best queued job needs less than some runner it may use, the longest of them gives way
+	while (heapCount)
+	{
+		Core* longest = NULL;
+		int c;
+		for (c = 0; c < coreCount; c++)
+		{
+			if (!allowed(strideHeap[0], c))
+			{
+				continue;
+			}
+			if (cores[c].job < 0)
+			{
+				return; // an idle core will take it
+			}
+			if (longest == NULL || work[cores[c].job] > work[longest->job])
+			{
+				longest = &cores[c];
+			}
+		}
+
+		if (longest == NULL || work[strideHeap[0]] >= work[longest->job])
+		{
+			return;
+		}
+
+		int pid = longest->job;
+		pass[pid] = work[pid];
+		processes.beginWaiting[pid] = simClock;
+		heap_push(pid);
+		longest->job = -1;
+		dispatch_to(longest, heap_pop());
+	} // end while
+} // end function preempt_machine()
+
+void dispatch_machine()
+{
+	//Idle cores take jobs off the queue in order, passing over jobs pinned away from every idle core
+	int skippedCount = 0;
+	while (heapCount && idle_cores())
+	{
+		int pid = heap_pop();
+		Core* core = place_job(pid);
+		if (core == NULL)
+		{
+			skipped[skippedCount++] = pid;
+			continue;
+		}
+
+		dispatch_to(core, pid);
+	} // end while
+
+	//Passed over jobs keep their place
+	while (skippedCount)
+	{
+		heap_push(skipped[--skippedCount]);
+	}
+} // end function dispatch_machine()
+
+int idle_cores()
+{
+	int count = 0;
+	int c;
+	for (c = 0; c < coreCount; c++)
+	{
+		count += (cores[c].job < 0);
+	}
+
+	return count;
+} // end function idle_cores()
+
+int allowed(int pid, int core)
+{
+	return (!processes.affinity[pid] || (processes.affinity[pid] & (1ULL << core)));
+} // end function allowed()
+
+Core* place_job(int pid)
+{
+	//Speed blind: the first idle core. Fastest: the quickest idle core. Short: short jobs
+	//take the quickest idle core, long ones the slowest, keeping fast cores free for short work.
+	//Near: the idle core closest to where the job last ran, the quickest among equals
+	int wantFast = !strcmp(placement, "fastest") || !strcmp(placement, "near") || (!strcmp(placement, "short") && work[pid] <= shortWork);
+	int wantSlow = !strcmp(placement, "short") && !wantFast;
+	int wantNear = !strcmp(placement, "near") && lastCore[pid] >= 0;
+
+	Core* best = NULL;
+	int bestDistance = 0;
+	int c;
+	for (c = 0; c < coreCount; c++)
+	{
+		Core* core = &cores[c];
+		if (core->job >= 0 || !allowed(pid, c))
+		{
+			continue;
+		}
+
+		int distance = wantNear ? core_distance(core, &cores[lastCore[pid]]) : 0;
+		if (best == NULL || distance < bestDistance
+			|| (distance == bestDistance && ((wantFast && core->steps[0] > best->steps[0]) || (wantSlow && core->steps[0] < best->steps[0]))))
+		{
+			best = core;
+			bestDistance = distance;
+		}
+	} // end for
+
+	return best;
+} // end function place_job()
+
+void dispatch_to(Core* core, int pid)
+{
+	core->job = pid;
+	core->jobsRun++;
+
+	//Coming back on another core costs the warm up of its caches, more the further it moved
+	if (lastCore[pid] >= 0 && &cores[lastCore[pid]] != core)
+	{
+		int level = core_distance(core, &cores[lastCore[pid]]) - 1;
+		migrations[level]++;
+		work[pid] += migrationCost[level] * WORK_SCALE;
+	}
+	lastCore[pid] = (int)(core - cores);
+
+	//Waiting ends whenever the job gets a core
+	processes.waitTime[pid] += simClock - processes.beginWaiting[pid];
+	if (!processes.started[pid])
+	{
+		processes.startTime[pid] = simClock;
+		processes.started[pid] = 1;
+	}
+} // end function dispatch_to()
+
+void set_core_speeds()
+{
+	//Governor: idle backlog means the slowest step, each job still waiting raises it one step
+	int c;
+	for (c = 0; c < coreCount; c++)
+	{
+		Core* core = &cores[c];
+		int step = (core->stepCount - 1) - heapCount;
+		core->speed = core->steps[(step > 0) ? step : 0];
+	}
+} // end function set_core_speeds()
+
+SimTime core_finish_time(Core* core)
+{
+	//Round up to the first tick at which the job's work is all retired
+	double perTick = core->speed * WORK_SCALE;
+	SimTime ticks = (SimTime)(work[core->job] / perTick);
+	while ((long long)(ticks * perTick) < work[core->job])
+	{
+		ticks++;
+	}
+
+	return simClock + ticks;
+} // end function core_finish_time()
+
+char* machine_label(Policy* policy)
+{
+	if (!strcmp(policy->name, "fcfs"))
+	{
+		return "First Come, First Serve";
+	}
+	if (!strcmp(policy->name, "sjf"))
+	{
+		return "Shortest Job First";
+	}
+	return "Shortest Remaining Time First";
+} // end function machine_label()
+
+void print_cores()
+{
+	//Label times with their unit, when the workload declared one
+	char* unit = (outputUnit != NULL) ? outputUnit->name : "";
+	char* space = (outputUnit != NULL) ? " " : "";
+	SimTime span = simClock - processes.arrivalTime[0];
+
+	int c;
+	for (c = 0; c < coreCount; c++)
+	{
+		Core* core = &cores[c];
+		printf("\tCore %d (speed %.2f", c, core->steps[0]);
+		int s;
+		for (s = 1; s < core->stepCount; s++)
+		{
+			printf("/%.2f", core->steps[s]);
+		}
+		printf(")");
+		if (topologyGiven)
+		{
+			printf(" node %d llc %d", core->node, core->llc);
+		}
+		printf(": busy %.2f%s%s (%.2f%%), %d jobs\n", to_output_unit(core->busyTime), space, unit,
+				span ? (100.0 * core->busyTime / span) : 0, core->jobsRun);
+	} // end for
+
+	printf("\tMigrations: %d within llc, %d across llc, %d across node\n", migrations[0], migrations[1], migrations[2]);
+} // end function print_cores()
@@ -0,0 +1,547 @@
+// ******************************************************************************************************************
+//  CPU Scheduler
+//  Copyright(C) 2018  James LoForti
+//  Contact Info: jamesloforti@gmail.com
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.If not, see<https://www.gnu.org/licenses/>.
+//									     ____.           .____             _____  _______   
+//									    |    |           |    |    ____   /  |  | \   _  \  
+//									    |    |   ______  |    |   /  _ \ /   |  |_/  /_\  \ 
+//									/\__|    |  /_____/  |    |__(  <_> )    ^   /\  \_/   \
+//									\________|           |_______ \____/\____   |  \_____  /
+//									                             \/          |__|        \/ 
+//
+// ******************************************************************************************************************
+//
+
+//Command line front end: reads a workload from stdin and runs the requested algorithms over it
+
+#include <stdlib.h> 
+#include <stdio.h> // needed for printf()
+#include <string.h> // needed for strtok()
+#include <unistd.h> // needed for getopt()
+#include "p5.h"
+
+int main(int argc, char* argv[])
+{
+	//Default to the 4 classic algorithms
+	char defaultAlgorithms[] = "fcfs,sjf,srtf,rr";
+	char* algorithms = defaultAlgorithms;
+
+	//Parse command line options
+	int opt;
+	char* reportUnit = NULL;
+	char* resumePath = NULL;
+	char* socketPath = NULL;
+	char* cacheDirectory = NULL;
+	char* machine = NULL;
+	char* topology = NULL;
+	char* costs = NULL;
+	char* dumpPath = NULL;
+	char* generator = NULL;
+	char* tick = NULL;
+	int replicas = 0;
+	char** edits = malloc(sizeof(char*) * argc); // one what-if query per -E
+	int editQueries = 0;
+	int workers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	int fromTrace = 0;
+	int packOutput = 0;
+	int traceCpu = -1;
+	int runSettings = 0; // -q, -s, -p, -b, -Q or -A given
+	while ((opt = getopt(argc, argv, "a:q:s:i:u:c:k:t:r:S:w:TC:ZR:E:HM:P:N:X:Q:A:L:W:D:m:g:p:b:Ol:z:")) != -1)
+	{
+		switch (opt)
+		{
+		case 'a': // comma separated list of algorithms to run
+			algorithms = optarg;
+			break;
+		case 'q': // time quantum for rr, lottery and stride
+			runSettings = 1;
+			quantum = strtoll(optarg, NULL, 10);
+			if (quantum <= 0)
+			{
+				fprintf(stderr, "%s: quantum must be positive\n", argv[0]);
+				return 1;
+			}
+			break;
+		case 's': // lottery seed
+			runSettings = 1;
+			randomState = strtoull(optarg, NULL, 10);
+			break;
+		case 'i': // share gap sampling interval
+			shareInterval = strtoll(optarg, NULL, 10);
+			break;
+		case 'u': // unit to report times in
+			reportUnit = optarg;
+			break;
+		case 'c': // checkpoint file
+			checkpointPath = optarg;
+			break;
+		case 'k': // checkpoint interval
+			checkpointInterval = strtoll(optarg, NULL, 10);
+			break;
+		case 't': // stop at the first checkpoint at or after this time
+			stopTime = strtoll(optarg, NULL, 10);
+			break;
+		case 'r': // resume from a checkpoint file
+			resumePath = optarg;
+			break;
+		case 'S': // serve requests on a unix socket instead of reading stdin
+			socketPath = optarg;
+			break;
+		case 'w': // worker threads for server mode, replication and split runs
+			workers = atoi(optarg);
+			break;
+		case 'T': // stdin is a perf sched / ftrace capture rather than a workload
+			fromTrace = 1;
+			break;
+		case 'C': // only replay what happened on this cpu of the trace
+			traceCpu = atoi(optarg);
+			break;
+		case 'Z': // write the workload to stdout in packed form instead of scheduling it
+			packOutput = 1;
+			break;
+		case 'R': // reuse reports cached in this directory, and cache new ones there
+			cacheDirectory = optarg;
+			break;
+		case 'M': // machine model, core speeds with optional DVFS steps: 2:1.5:1,1,1
+			machine = optarg;
+			break;
+		case 'P': // which idle core a job goes to on the machine model
+			placement = optarg;
+			break;
+		case 'N': // NUMA nodes and llc domains per node to split the cores into: 2,2
+			topology = optarg;
+			break;
+		case 'X': // work a migration costs within an llc, across llcs, across nodes
+			costs = optarg;
+			break;
+		case 'Q': // jobs allowed to wait in the run queue before admission control sheds one
+			runSettings = 1;
+			queueCapacity = atoi(optarg);
+			if (queueCapacity <= 0)
+			{
+				fprintf(stderr, "%s: queue capacity must be positive\n", argv[0]);
+				return 1;
+			}
+			break;
+		case 'A': // who is shed from a full run queue
+			runSettings = 1;
+			admission = optarg;
+			break;
+		case 'L': // write each run's time series to <path>.<algorithm>
+			telemetryPath = optarg;
+			break;
+		case 'W': // simulated time per telemetry window
+			telemetryWindow = strtoll(optarg, NULL, 10);
+			break;
+		case 'D': // print a telemetry file as a table and exit
+			dumpPath = optarg;
+			break;
+		case 'm': // replicate the run over this many variants of the workload
+			replicas = atoi(optarg);
+			if (replicas <= 0)
+			{
+				fprintf(stderr, "%s: replicas must be positive\n", argv[0]);
+				return 1;
+			}
+			break;
+		case 'g': // generate the variants from a distribution instead: jobs:gap:burst[:alpha]
+			generator = optarg;
+			if (!parse_generator(generator))
+			{
+				fprintf(stderr, "%s: -g takes jobs:gap:burst[:alpha], with a positive job count, bursts of at least 1 and alpha above 1\n", argv[0]);
+				return 1;
+			}
+			break;
+		case 'p': // psjf and psrtf burst prediction: alpha[:initial guess]
+			runSettings = 1;
+			if (!parse_prediction(optarg))
+			{
+				fprintf(stderr, "%s: -p takes alpha in (0, 1], optionally followed by :initial with initial at least 1\n", argv[0]);
+				return 1;
+			}
+			break;
+		case 'b': // arr slice bounds: min:max[:target latency for a turn of the queue]
+			runSettings = 1;
+			if (!parse_adaptive(optarg))
+			{
+				fprintf(stderr, "%s: -b takes min:max with 1 <= min <= max, optionally followed by :latency of at least 1\n", argv[0]);
+				return 1;
+			}
+			break;
+		case 'O': // follow the averages with their gap from the SRPT and makespan bounds
+			showGap = 1;
+			break;
+		case 'z': // srtf and rr on a timer tick: period or rate[hz], then cost per tick and periodic or tickless idle
+			tick = optarg;
+			if (!parse_tick(optarg))
+			{
+				fprintf(stderr, "%s: -z takes a period or a rate like 250hz, optionally followed by :cost below the period and :periodic or :tickless\n", argv[0]);
+				return 1;
+			}
+			break;
+		case 'l': // load a policy plugin, which -a can then name
+			if (!load_plugin(optarg))
+			{
+				fprintf(stderr, "%s: -l %s: %s\n", argv[0], optarg, pluginError);
+				return 1;
+			}
+			break;
+		case 'H': // follow the averages with the extremes and a turnaround histogram
+			showSpread = 1;
+			break;
+		case 'E': // a what-if query to replay against each run: pid=burst,...
+			edits[editQueries++] = optarg;
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-a fcfs,sjf,srtf,rr,lottery,stride,group,psjf,psrtf,arr] [-q quantum] [-s seed] [-i interval] [-u ns|us|ms|s]\n"
+					"\t[-c checkpoint -k interval [-t stop]] [-r checkpoint] [-T [-C cpu]] [-Z] [-R cache] [-E pid=burst,...]\n"
+					"\t[-M speed[:step...],... [-P first|fastest|short|near] [-N nodes[,llcs]] [-X cost[,cost,cost]]]\n"
+					"\t[-Q capacity [-A reject|oldest|priority|deadline]] [-L telemetry [-W window]] [-p alpha[:initial]]\n"
+					"\t[-b min:max[:latency]] [-O] [-H] [-z tick[:cost[:tickless]]]\n"
+					"\t[-l plugin.so ...] [-w workers] < data\n"
+					"       %s -m replicas [-g jobs:gap:burst[:alpha] | < data] [-w workers]\n"
+					"       %s -D telemetry\n"
+					"       %s -S socket [-w workers]\n", argv[0], argv[0], argv[0], argv[0]);
+			return 1;
+		}
+	} // end while
+
+	//Reading a time series back needs no workload
+	if (dumpPath != NULL)
+	{
+		FILE* file = fopen(dumpPath, "rb");
+		if (file == NULL)
+		{
+			perror(dumpPath);
+			return 1;
+		}
+		print_telemetry(file);
+		fclose(file);
+		return 0;
+	}
+
+	//Telemetry is taken from a whole, single cpu run
+	if (telemetryPath != NULL && (machine != NULL || checkpointPath != NULL || resumePath != NULL || editQueries))
+	{
+		fprintf(stderr, "%s: -L can't be combined with -M, -c, -r or -E\n", argv[0]);
+		return 1;
+	}
+
+	//Replication runs whole workloads, quietly, in worker threads
+	if (generator != NULL && !replicas)
+	{
+		fprintf(stderr, "%s: -g generates the variants for -m\n", argv[0]);
+		return 1;
+	}
+	if (replicas && (machine != NULL || checkpointPath != NULL || resumePath != NULL || editQueries || telemetryPath != NULL || cacheDirectory != NULL || packOutput))
+	{
+		fprintf(stderr, "%s: -m can't be combined with -M, -c, -r, -E, -L, -R or -Z\n", argv[0]);
+		return 1;
+	}
+
+	//Snapshots need somewhere to go and a pace to be taken at
+	if ((checkpointInterval > 0 || stopTime >= 0) && checkpointPath == NULL)
+	{
+		fprintf(stderr, "%s: -k and -t need a checkpoint file (-c)\n", argv[0]);
+		return 1;
+	}
+	if (stopTime >= 0 && checkpointInterval <= 0)
+	{
+		fprintf(stderr, "%s: -t needs a checkpoint interval (-k)\n", argv[0]);
+		return 1;
+	}
+
+	if ((topology != NULL || costs != NULL) && machine == NULL)
+	{
+		fprintf(stderr, "%s: -N and -X describe the machine, so they need -M\n", argv[0]);
+		return 1;
+	}
+
+	//The machine model runs its own event loop, so it can't be snapshotted
+	if (machine != NULL)
+	{
+		if (!parse_machine(machine))
+		{
+			fprintf(stderr, "%s: -M takes up to %d comma separated cores, each a speed or up to %d colon separated steps\n", argv[0], MAX_CORES, MAX_STEPS);
+			return 1;
+		}
+		if (topology != NULL && !parse_topology(topology))
+		{
+			fprintf(stderr, "%s: -N takes nodes[,llcs per node] that divide the %d cores evenly\n", argv[0], coreCount);
+			return 1;
+		}
+		if (costs != NULL && !parse_migration_costs(costs))
+		{
+			fprintf(stderr, "%s: -X takes up to 3 non-negative costs\n", argv[0]);
+			return 1;
+		}
+		if (strcmp(placement, "first") && strcmp(placement, "fastest") && strcmp(placement, "short") && strcmp(placement, "near"))
+		{
+			fprintf(stderr, "%s: unknown placement '%s'\n", argv[0], placement);
+			return 1;
+		}
+		if (checkpointPath != NULL || resumePath != NULL || editQueries)
+		{
+			fprintf(stderr, "%s: -M can't be combined with -c, -r or -E\n", argv[0]);
+			return 1;
+		}
+	}
+
+	//Ticked runs have a loop of their own, for one cpu run to completion, and only srtf and rr have a tick to wait for
+	char tickAlgorithms[] = "srtf,rr";
+	if (tick != NULL && algorithms == defaultAlgorithms)
+	{
+		algorithms = tickAlgorithms;
+	}
+	if (tick != NULL && (machine != NULL || checkpointPath != NULL || resumePath != NULL || editQueries || queueCapacity > 0 || replicas || socketPath != NULL))
+	{
+		fprintf(stderr, "%s: -z can't be combined with -M, -c, -r, -E, -Q, -m or -S\n", argv[0]);
+		return 1;
+	}
+
+	//Admission control works on the run queue of the single cpu event loops
+	if (find_admission(admission) == NULL)
+	{
+		fprintf(stderr, "%s: unknown admission policy '%s'\n", argv[0], admission);
+		return 1;
+	}
+	if (queueCapacity > 0 && machine != NULL)
+	{
+		fprintf(stderr, "%s: -Q can't be combined with -M\n", argv[0]);
+		return 1;
+	}
+
+	//A resumed run finishes under the settings it was checkpointed with
+	if (resumePath != NULL && runSettings)
+	{
+		fprintf(stderr, "%s: -r takes the run's settings from the checkpoint, so it can't be combined with -q, -s, -p, -b, -Q or -A\n", argv[0]);
+		return 1;
+	}
+
+	//What-if replays keep their own snapshots
+	if (editQueries && (checkpointPath != NULL || resumePath != NULL))
+	{
+		fprintf(stderr, "%s: -E can't be combined with -c or -r\n", argv[0]);
+		return 1;
+	}
+
+	//A zero seed would leave xorshift stuck at zero
+	if (!randomState)
+	{
+		randomState = 1;
+	}
+
+	//Server mode takes its workloads from the socket
+	if (socketPath != NULL)
+	{
+		return serve(socketPath, (workers > 0) ? workers : 1);
+	}
+
+	//Validate the algorithms before doing any work
+	char* check = strdup(algorithms);
+	char* name;
+	for (name = strtok(check, ","); name != NULL; name = strtok(NULL, ","))
+	{
+		if (find_policy(name) == NULL)
+		{
+			fprintf(stderr, "%s: unknown algorithm '%s'\n", argv[0], name);
+			return 1;
+		}
+		if (coreCount && !machine_supports(name))
+		{
+			fprintf(stderr, "%s: -M runs fcfs, sjf and srtf, not '%s'\n", argv[0], name);
+			return 1;
+		}
+		if (queueCapacity > 0 && !(find_policy(name)->uses & USES_QUEUE))
+		{
+			fprintf(stderr, "%s: -Q bounds the run queue of srtf, psrtf, rr and arr, not '%s'\n", argv[0], name);
+			return 1;
+		}
+		if (tick != NULL && !ticks_supported(name))
+		{
+			fprintf(stderr, "%s: -z runs srtf and rr on a tick, not '%s'\n", argv[0], name);
+			return 1;
+		}
+		if (editQueries && find_policy(name)->resume == NULL)
+		{
+			fprintf(stderr, "%s: -E needs algorithms that can be resumed, not '%s'\n", argv[0], name);
+			return 1;
+		}
+	} // end for
+	free(check);
+
+	//Print opening seperator, name
+	if (!packOutput)
+	{
+		printf("\n*********************************************** "
+				"\nName: James LoForti \n\n");
+	}
+
+	//Read in the raw data and create an array of processes, unless the replicas bring their own
+	if (generator == NULL)
+	{
+		int first = getc(stdin);
+		ungetc(first, stdin);
+		if (first == (unsigned char)PACKED_MAGIC[0])
+		{
+			read_packed(stdin);
+		}
+		else if (fromTrace)
+		{
+			read_trace(traceCpu);
+		}
+		else
+		{
+			read_raw_data();
+		}
+
+		if (!numProcesses)
+		{
+			fprintf(stderr, "%s: no processes to schedule\n", argv[0]);
+			return 1;
+		}
+	} // end if
+
+	//Convert rather than schedule
+	if (packOutput)
+	{
+		write_packed(stdout);
+		return 0;
+	}
+
+	//A tick rate is a period in the workload's unit
+	if (tick != NULL && !resolve_tick())
+	{
+		fprintf(stderr, "%s: -z needs a tick longer than its cost, and a rate needs a workload that declares its units\n", argv[0]);
+		return 1;
+	}
+
+	//Pinned jobs need a core on this machine
+	if (coreCount && check_affinity() >= 0)
+	{
+		fprintf(stderr, "%s: process %d is pinned to cores the machine doesn't have\n", argv[0], check_affinity());
+		return 1;
+	}
+
+	//Edits refer to pids in arrival order
+	int i;
+	for (i = 0; i < editQueries; i++)
+	{
+		if (!parse_edits(edits[i]))
+		{
+			fprintf(stderr, "%s: -E takes pid=burst pairs, with pids below %d and positive bursts\n", argv[0], numProcesses);
+			return 1;
+		}
+	} // end for
+
+	//Report in the workload's own unit unless asked otherwise
+	outputUnit = inputUnit;
+	if (reportUnit != NULL)
+	{
+		outputUnit = find_unit(reportUnit);
+
+		if (outputUnit == NULL || inputUnit == NULL)
+		{
+			fprintf(stderr, "%s: -u needs a known unit and a workload that declares its units\n", argv[0]);
+			return 1;
+		}
+	}
+
+	//Run the policies over every variant and report the spread of the results
+	if (replicas)
+	{
+		if (groupCount > 1)
+		{
+			fprintf(stderr, "%s: -m can't resample fair share groups\n", argv[0]);
+			return 1;
+		}
+
+		int status = replicate(algorithms, replicas, (workers > 0) ? workers : 1);
+		printf("\n*********************************************** \n");
+		return status;
+	}
+
+	//Initialize globals
+	init_all();
+
+	//Pick up a snapshotted run where it left off
+	if (resumePath != NULL)
+	{
+		Policy* policy = read_checkpoint(resumePath);
+		policy->resume();
+
+		printf("\n*********************************************** \n");
+		return 0;
+	}
+
+	//Copy the process table so original is uneffected
+	ProcessTable processesCopy = { 0 };
+	table_reserve(&processesCopy, processes.capacity);
+	table_copy(&processesCopy, &processes, numProcesses + 1);
+
+	//Exercise every requested algorithm
+	for (name = strtok(algorithms, ","); name != NULL; name = strtok(NULL, ","))
+	{
+		init_all();
+		table_copy(&processes, &processesCopy, numProcesses + 1);
+		nextCheckpoint = processes.arrivalTime[0] + checkpointInterval;
+
+		if (coreCount)
+		{
+			run_machine(find_policy(name));
+		}
+		else if (editQueries)
+		{
+			what_if(find_policy(name), &processesCopy, edits, editQueries);
+		}
+		else if (tick != NULL) // the cache doesn't key on the tick
+		{
+			run_ticked(find_policy(name));
+		}
+		else if (cacheDirectory != NULL && checkpointInterval <= 0 && telemetryPath == NULL && !(find_policy(name)->uses & USES_PLUGIN)) // a run cut short by a checkpoint has no report worth keeping, telemetry needs the run itself, and a plugin may have been rebuilt
+		{
+			run_cached(find_policy(name), cacheDirectory);
+		}
+		else if (workers > 1 && checkpointInterval <= 0 && splits_at_idle(name)) // spread the busy periods over the workers
+		{
+			run_split(find_policy(name), workers);
+		}
+		else
+		{
+			find_policy(name)->run();
+		}
+
+		if (telemetryPath != NULL)
+		{
+			write_telemetry(name);
+		}
+	} // end for
+
+	table_destructor(&processesCopy);
+
+	//Set the kernel's own schedule alongside the simulated ones
+	if (fromTrace && observedJobs)
+	{
+		print("Kernel (observed)", to_output_unit(observed.responseTime), to_output_unit(observed.turnTime), to_output_unit(observed.waitTime));
+	}
+
+	//Print closing seperator
+	printf("\n*********************************************** \n");
+
+	getchar();
+
+	return 0;
+} // end main()
@@ -27,198 +27,299 @@
 
 //Project Purpose:
 //To emulate a CPU scheduler, using the following algorithms:
-//First come first serve, shortest job first, shortest remaining time first, and round robin
+//First come first serve, shortest job first, shortest remaining time first, round robin,
+//and the proportional-share lottery and stride schedulers
 
 #include <stdlib.h> 
 #include <stdio.h> // needed for printf()
 #include <string.h> // needed for memcpy()
+#include <inttypes.h> // needed for PRId64, SCNd64
 #include "p5.h"
 
-//Declare globals
-int rawData[MAX_PROCESSES * 2]; // 25 processes * 2 values each
-Process processes[MAX_PROCESSES];
-Process pendingSJF[MAX_PROCESSES];
-List waitingList;
-int running;
-int clock;
-int numProcesses;
-int processesRemaining;
-int countSJF;
-
-int main(int argc, char* argv[])
+//Declare globals, private to each thread so simulations can run side by side
+PER_THREAD ProcessTable processes; // one column per field, one spare zeroed row past the end
+PER_THREAD int* pendingSJF; // pids of arrived processes, sorted by burst
+PER_THREAD List waitingList;
+PER_THREAD List spareNodes; // nodes recycled off the wait list, reused before allocating
+PER_THREAD int running;
+PER_THREAD SimTime simClock;
+PER_THREAD int numProcesses;
+PER_THREAD int processesRemaining;
+PER_THREAD SimTime quantum = QUANTUM;
+PER_THREAD int quiet; // suppress console output, for library callers
+PER_THREAD Summary summary; // averages from the last run
+PER_THREAD int showSpread; // print extremes and a turnaround histogram after the averages
+PER_THREAD int countSJF;
+
+//Proportional share globals
+PER_THREAD long long* fenwick; // lottery ticket index, 1-based
+PER_THREAD long long totalTickets;
+PER_THREAD int* strideHeap; // stride run queue, keyed on pass value
+PER_THREAD int heapCount;
+PER_THREAD long long* pass;
+PER_THREAD long long globalPass;
+PER_THREAD SimTime* remainingBurst;
+PER_THREAD int* shareSlot; // position in shareActive, -1 if not runnable
+PER_THREAD int* shareActive; // runnable processes, for share gap sampling
+PER_THREAD int shareCount;
+PER_THREAD int nextArrival; // next process yet to arrive
+PER_THREAD long long totalWeight;
+PER_THREAD double* shareJoined; // virtual time at which each process became runnable
+PER_THREAD SimTime* shareService; // CPU time received since becoming runnable
+PER_THREAD double virtualTime; // ideal service per unit of weight, integrated over time
+PER_THREAD SimTime shareInterval; // simulated time between share gap samples, 0 = auto
+PER_THREAD SimTime nextShareSample;
+PER_THREAD int shareCapacity; // rows allocated in the buffers above
+PER_THREAD unsigned long long randomState = 1;
+const P5Policy lotteryPolicy = { P5_POLICY_ABI, "lottery", NULL, join_lottery, pick_lottery, requeue_lottery, leave_lottery, NULL };
+const P5Policy stridePolicy = { P5_POLICY_ABI, "stride", NULL, join_stride, pick_stride, requeue_stride, leave_stride, NULL };
+
+//Time unit globals
+TimeUnit timeUnits[] =
 {
-	//Print opening seperator, name
-	printf("\n*********************************************** "
-			"\nName: James LoForti \n\n");
-
-	//Read in the raw data and create an array of processes
-	read_raw_data();
-
-	//Initialize globals
-	init_all();
-
-	//Copy array of processes so original is uneffected
-	Process processesCopy[MAX_PROCESSES];
-	memcpy(&processesCopy, &processes, sizeof(processes));
+	{ "ns", 1 },
+	{ "us", 1000 },
+	{ "ms", 1000000 },
+	{ "s", 1000000000 },
+	{ NULL, 0 }
+};
+PER_THREAD TimeUnit* inputUnit; // declared by the workload, NULL for abstract units
+PER_THREAD TimeUnit* outputUnit; // unit averages are reported in
+
+//Checkpoint globals
+PER_THREAD unsigned long long workloadFingerprint; // hash of the workload as read, before any run mutates it
+PER_THREAD char* checkpointPath;
+PER_THREAD SimTime checkpointInterval; // simulated time between snapshots, 0 = never
+PER_THREAD SimTime stopTime = -1; // end of this time slice, -1 = run to completion
+PER_THREAD SimTime nextCheckpoint;
+
+Policy policies[POLICY_SLOTS] = // plugins loaded with -l fill the spare slots
+{
+	{ "fcfs", fcfs, NULL, 0 },
+	{ "sjf", sjf, NULL, 0 },
+	{ "srtf", srtf, run_srtf, USES_QUEUE },
+	{ "psjf", psjf, NULL, USES_QUANTUM | USES_PREDICTION },
+	{ "psrtf", psrtf, resume_psrtf, USES_QUANTUM | USES_QUEUE | USES_PREDICTION },
+	{ "rr", rr, run_rr, USES_QUANTUM | USES_QUEUE },
+	{ "arr", arr, resume_arr, USES_QUANTUM | USES_QUEUE | USES_ADAPTIVE },
+	{ "lottery", lottery, NULL, USES_QUANTUM | USES_SEED | USES_INTERVAL },
+	{ "stride", stride, NULL, USES_QUANTUM | USES_INTERVAL },
+	{ "group", group_fair, NULL, USES_QUANTUM | USES_INTERVAL },
+	{ NULL, NULL, NULL, 0 }
+};
 
-	//Exercise all 4 algorithms
-	fcfs();
+void read_raw_data()
+{
+	//Read one process per line: arrival time, burst time, then optional key=value attributes
+	char* line = NULL;
+	size_t length = 0;
+	while (getline(&line, &length, stdin) != -1)
+	{
+		SimTime arrivalTime, burstTime;
+		int consumed;
+		char unit[8];
 
-	init_all();
-	memcpy(&processes, &processesCopy, sizeof(processes));
+		//A "units ns" line declares what the times are measured in
+		if (sscanf(line, " units %7s", unit) == 1)
+		{
+			inputUnit = find_unit(unit);
 
-	sjf();
+			if (inputUnit == NULL)
+			{
+				fprintf(stderr, "unknown time unit '%s'\n", unit);
+				exit(1);
+			}
+			continue;
+		}
 
-	init_all();
-	memcpy(&processes, &processesCopy, sizeof(processes));
+		//A "group /path weight=N max=Q/P" line sets up a fair share group
+		if (read_group(line))
+		{
+			continue;
+		}
 
-	srtf();
+		//Skip blank lines and comments
+		if (sscanf(line, "%" SCNd64 " %" SCNd64 "%n", &arrivalTime, &burstTime, &consumed) != 2)
+		{
+			continue;
+		}
 
-	init_all();
-	memcpy(&processes, &processesCopy, sizeof(processes));
+		int pid = add_process(arrivalTime, burstTime);
+		read_attributes(pid, line + consumed);
+	} // end while
+	free(line);
 
-	rr();
+	finish_workload();
+} // end function read_raw_data
 
-	//Print closing seperator
-	printf("\n*********************************************** \n");
+void finish_workload()
+{
+	//For every process but the last
+	int i;
+	for (i = 0; i + 1 < numProcesses; i++)
+	{
+		//Save next processes arrival time
+		processes.nextArriving[i] = processes.arrivalTime[i + 1];
+	} // end for
 
-	getchar();
+	workloadFingerprint = fingerprint_workload();
+	predict_bursts();
 
-	return 0;
-} // end main()
+	//The bounds need the bursts before any policy rewrites them
+	if (showGap)
+	{
+		compute_bounds();
+	}
+} // end function finish_workload()
 
-void read_raw_data()
+void read_attributes(int pid, char* attributes)
 {
-	//Function vars:
-	int rawCount = 0;
-	int count = 0;
-
-	//Read process arrival times & burst times from stdin
-	int num;
-	while (fscanf(stdin, "%d", &num) == 1)
+	//For every whitespace separated key=value pair
+	char* token;
+	for (token = strtok(attributes, " \t\r\n"); token != NULL; token = strtok(NULL, " \t\r\n"))
 	{
-		//Save the data to an array
-		rawData[rawCount++] = num;
-	} // end while
-
-	//Save the total number of processes
-	numProcesses = (rawCount / 2);
+		if (strncmp(token, "weight=", 7) == 0)
+		{
+			processes.weight[pid] = atoi(token + 7);
 
-	//For every set of raw data
-	int i;
-	for (i = 0; i < numProcesses; i++)
-	{
-		//Even = Arrival / Odd = Burst
-		processes[i].arrivalTime = rawData[i * 2];
-		processes[i].burstTime = rawData[(i * 2) + 1];
-		processes[i].pid = i;
+			if (processes.weight[pid] <= 0)
+			{
+				fprintf(stderr, "process %d: weight must be positive\n", pid);
+				exit(1);
+			}
+		}
+		else if (strncmp(token, "task=", 5) == 0)
+		{
+			processes.task[pid] = atoi(token + 5);
+		}
+		else if (strncmp(token, "group=", 6) == 0)
+		{
+			processes.group[pid] = find_group(token + 6, 1);
+			if (processes.group[pid] < 0)
+			{
+				fprintf(stderr, "process %d: group paths start with /\n", pid);
+				exit(1);
+			}
+		}
+		else if (strncmp(token, "deadline=", 9) == 0)
+		{
+			processes.deadline[pid] = strtoll(token + 9, NULL, 10);
 
-		//If this isn't the last process
-		if ((i * 2) + 2 < rawCount)
+			if (processes.deadline[pid] <= 0)
+			{
+				fprintf(stderr, "process %d: deadline must be positive\n", pid);
+				exit(1);
+			}
+		}
+		else if (strncmp(token, "cpus=", 5) == 0)
+		{
+			if (!parse_cpu_list(token + 5, &processes.affinity[pid]))
+			{
+				fprintf(stderr, "process %d: cpus takes core numbers and ranges below %d, like 0-3,8\n", pid, MAX_CORES);
+				exit(1);
+			}
+		}
+		else
 		{
-			//Save next processes arrival time
-			processes[i].nextArriving = rawData[(i * 2) + 2];
+			fprintf(stderr, "process %d: unknown attribute '%s'\n", pid, token);
+			exit(1);
 		}
 	} // end for
-} // end function read_raw_data
-
-//***************************************************************************FIRST COME FIRST SERVE
+} // end function read_attributes()
 
-void fcfs()
+int add_process(SimTime arrivalTime, SimTime burstTime)
 {
-	//Initialize runner
-	running = processes[0].pid;
-	processes[0].startTime = processes[0].arrivalTime;
-	clock = processes[0].startTime;
-
-	//While processes remain to be executed
-	while (processesRemaining)
+	//Keep room for the zeroed row past the last process
+	if (numProcesses + 1 >= processes.capacity)
 	{
-		next_process();
-		update();
+		int capacity = processes.capacity ? processes.capacity * 2 : MAX_PROCESSES;
+		table_reserve(&processes, capacity);
+		pendingSJF = realloc(pendingSJF, sizeof(int) * capacity);
 	}
 
-	//Calculate avg times and print to console
-	calc_times_and_print("First Come, First Serve");
-} // end function fcfs()
+	//Rows may be left over from an earlier workload, so clear this one and the spare past it
+	int pid = numProcesses++;
+#define CLEAR_COLUMN(type, name) \
+	memset(&processes.name[pid], 0, sizeof(type) * 2);
+	PROCESS_COLUMNS(CLEAR_COLUMN)
+#undef CLEAR_COLUMN
+
+	processes.arrivalTime[pid] = arrivalTime;
+	processes.burstTime[pid] = burstTime;
+	processes.weight[pid] = 1;
 
-void next_process()
+	return pid;
+} // end function add_process()
+
+TimeUnit* find_unit(char* name)
 {
-	//For every process (except for the 1st)
 	int i;
-	for (i = 1; i < numProcesses; i++)
+	for (i = 0; timeUnits[i].name != NULL; i++)
 	{
-		//If the process isn't dead
-		if (processes[i].flag != -1)
+		if (strcmp(timeUnits[i].name, name) == 0)
 		{
-			//If the process has arrived
-			if (processes[i].arrivalTime <= clock)
-			{
-				//Add it to the list
-				send_to_waiting(&processes[i]);
-
-				//Remove process and decrement count
-				processes[i].flag = -1;
-				processesRemaining--;
-			}
-		} // end for
+			return &timeUnits[i];
+		}
 	} // end for
-} // end function next_event()
 
-void update()
+	return NULL;
+} // end function find_unit()
+
+Policy* find_policy(char* name)
 {
-	//If there's processes waiting
-	if (waitingList.count)
+	int i;
+	for (i = 0; policies[i].name != NULL; i++)
 	{
-		//Save the count since we'll loose it later
-		int waitingCount = waitingList.count;
-
-		//For every process waiting
-		int i;
-		for (i = 0; i < waitingCount; i++)
+		if (strcmp(policies[i].name, name) == 0)
 		{
-			//Save the next process
-			Node* next = pop_front(&waitingList);
-
-			//Save as runner
-			running = next->data->pid;
-			processes[running].startTime = clock;
+			return &policies[i];
+		}
+	} // end for
 
-			//If the now running process had to wait
-			if (processes[running].startTime > processes[running].arrivalTime)
-			{
-				//Calc and add wait time to total process wait time
-				int currWait = (processes[running].startTime - processes[running].arrivalTime);
-				processes[running].waitTime += currWait;
-			}
+	return NULL;
+} // end function find_policy()
 
-			//Set clock to next event (current running process's end time)
-			clock = (processes[running].startTime + processes[running].burstTime);
-			processes[running].endTime = clock; // finish the current running process
-		} // end for
-	} // end if
+//***************************************************************************FIRST COME FIRST SERVE
 
-	//Set clock to next event (current running process's end time)
-	clock = (processes[running].startTime + processes[running].burstTime);
-	processes[running].endTime = clock; // finish the current running process
+void fcfs()
+{
+	//One FIFO CPU never preempts, so each job starts when it arrives or when the job
+	//before it ends, whichever is later: a single pass, no queue
+	SimTime* arrival = processes.arrivalTime;
+	SimTime* burst = processes.burstTime;
+	SimTime* start = processes.startTime;
+	SimTime* end = processes.endTime;
+	SimTime* wait = processes.waitTime;
+	SimTime previousEnd = arrival[0];
 
-	//If the next process hasn't arrived
-	if (processes[running + 1].arrivalTime > clock)
+	int i;
+	for (i = 0; i < numProcesses; i++)
 	{
-		//Set the clock next process start time
-		clock = processes[running + 1].arrivalTime; 
-	}
-} // end function update()
+		SimTime begin = (arrival[i] > previousEnd) ? arrival[i] : previousEnd;
+		start[i] = begin;
+		wait[i] = begin - arrival[i];
+		previousEnd = begin + burst[i];
+		end[i] = previousEnd;
+	} // end for
+
+	//Leave the clock where the event loop would have
+	simClock = previousEnd;
+	running = numProcesses - 1;
+	processesRemaining = 0;
+
+	//Calculate avg times and print to console
+	calc_times_and_print("First Come, First Serve");
+} // end function fcfs()
 
 //***************************************************************************SHORTEST JOB FIRST
 
 void sjf()
 {
 	//Initialize runner
-	running = processes[0].pid;
-	processes[0].flag = -1;
-	processes[0].startTime = processes[0].arrivalTime;
-	clock = processes[0].startTime;
+	running = 0;
+	processes.flag[0] = -1;
+	processes.startTime[0] = processes.arrivalTime[0];
+	simClock = processes.startTime[0];
 	
 	//While processes remain to be executed
 	while (processesRemaining)
@@ -228,31 +329,27 @@ void sjf()
 	}
 
 	//Calculate avg times and print to console
-	calc_times_and_print("Shortest Job First");
+	char label[64];
+	calc_times_and_print(prediction_label("Shortest Job First", label, sizeof(label)));
 } // end function sjf()
 
 void next_process_sjf()
 {
-	//For every element in the sjfPending array
-	int i;
-	for (i = 0; i < numProcesses; i++)
-	{
-		//Clear it out
-		memset(&pendingSJF[i], 0, sizeof(Process));
-	}
+	//Start a fresh list of pending processes
 	countSJF = 0;
 
 	//For every process (except for the 1st)
+	int i;
 	for (i = 1; i < numProcesses; i++)
 	{
 		//If this process has not already ended
-		if (processes[i].flag != -1)
+		if (processes.flag[i] != -1)
 		{
 			//If this process has arrived
-			if (processes[i].arrivalTime <= clock)
+			if (processes.arrivalTime[i] <= simClock)
 			{
 				//Add potential next process to array
-				pendingSJF[countSJF++] = processes[i];
+				pendingSJF[countSJF++] = i;
 			} // end if
 		} // end for
 	} // end for
@@ -267,33 +364,33 @@ void update_sjf()
 		sort_by_burst_sjf();
 
 		//Save next process as running, set its start time, mark as run, decrement count
-		running = pendingSJF[0].pid;
-		processes[running].startTime = clock;
-		processes[running].flag = -1;
+		running = pendingSJF[0];
+		processes.startTime[running] = simClock;
+		processes.flag[running] = -1;
 		processesRemaining--;
 
 		//If the now running process had to wait
-		if (processes[running].startTime > processes[running].arrivalTime)
+		if (processes.startTime[running] > processes.arrivalTime[running])
 		{
 			//Calc and add wait time to total process wait time
-			int currWait = (processes[running].startTime - processes[running].arrivalTime);
-			processes[running].waitTime += currWait;
+			SimTime currWait = (processes.startTime[running] - processes.arrivalTime[running]);
+			processes.waitTime[running] += currWait;
 		} // end if
 
 		//Set clock to next event (current running process's end time)
-		clock = (processes[running].startTime + processes[running].burstTime);
-		processes[running].endTime = clock; // finish the current running process
+		simClock = (processes.startTime[running] + processes.burstTime[running]);
+		processes.endTime[running] = simClock; // finish the current running process
 
 	} // end if
 	else // no processes ready
 	{
 		//Set clock to next event (current running process's end time)
-		clock = (processes[running].startTime + processes[running].burstTime);
-		processes[running].endTime = clock; // finish the current running process
+		simClock = (processes.startTime[running] + processes.burstTime[running]);
+		processes.endTime[running] = simClock; // finish the current running process
 	} // end else
 
 	//If no processes have arrived
-	if (countSJF == 0 && running != 0)
+	if (countSJF == 0)
 	{
 		//Find the next arriving process
 		sort_by_arrival_sjf();
@@ -302,10 +399,13 @@ void update_sjf()
 		for (i = 0; i < numProcesses; i++)
 		{
 			//If that process hasn't already run
-			if (processes[i].flag != -1)
+			if (processes.flag[i] != -1)
 			{
-				//Set the clock to the that processes start time
-				clock = processes[i].arrivalTime;
+				//Idle until it arrives, unless it came while the first process was still running
+				if (processes.arrivalTime[i] > simClock)
+				{
+					simClock = processes.arrivalTime[i];
+				}
 				break;
 			}
 		} // end for
@@ -314,22 +414,25 @@ void update_sjf()
 
 void sort_by_burst_sjf()
 {
+	//Order by the bursts, or the predicted ones
+	SimTime* burst = burst_keys();
+
 	//for-loop for outer values
 	int j;
 	for (j = 0; j < countSJF; j++)
 	{
 		//for-loop for all inner values
 		int i;
-		for (i = 0; i < countSJF; i++)
+		for (i = 0; i + 1 < countSJF; i++)
 		{
 			//Skip comparison test if uninitialized values are encountered
-			if (pendingSJF[i].burstTime != 0 && pendingSJF[i + 1].burstTime != 0)
+			if (burst[pendingSJF[i]] != 0 && burst[pendingSJF[i + 1]] != 0)
 			{
 				//If the next burst is lower than the current burst
-				if (pendingSJF[i].burstTime > pendingSJF[i + 1].burstTime)
+				if (burst[pendingSJF[i]] > burst[pendingSJF[i + 1]])
 				{
-					//Swap the processes
-					Process temp = pendingSJF[i];
+					//Swap the pids
+					int temp = pendingSJF[i];
 					pendingSJF[i] = pendingSJF[i + 1];
 					pendingSJF[i + 1] = temp;
 				}
@@ -349,15 +452,13 @@ void sort_by_arrival_sjf()
 		for (i = 0; i < countSJF; i++)
 		{
 			//Skip comparison test if uninitialized values are encountered
-			if (processes[i].arrivalTime != 0 && processes[i + 1].arrivalTime != 0)
+			if (processes.arrivalTime[i] != 0 && processes.arrivalTime[i + 1] != 0)
 			{
 				//If the next burst is lower than the current burst
-				if (processes[i].arrivalTime > processes[i + 1].arrivalTime)
+				if (processes.arrivalTime[i] > processes.arrivalTime[i + 1])
 				{
 					//Swap the processes
-					Process temp = processes[i];
-					processes[i] = processes[i + 1];
-					processes[i + 1] = temp;
+					table_swap(&processes, i, i + 1);
 				}
 			} // end if
 		} // end for
@@ -369,13 +470,26 @@ void sort_by_arrival_sjf()
 void srtf()
 {
 	//Initialize runner
-	running = processes[0].pid;
-	processes[0].startTime = processes[0].arrivalTime;
-	clock = processes[0].startTime;
+	running = 0;
+	processes.startTime[0] = processes.arrivalTime[0];
+	processes.latestStartTime[0] = processes.startTime[0];
+	processes.started[0] = 1;
+	simClock = processes.startTime[0];
+
+	run_srtf();
+} // end function srtf()
 
+void run_srtf()
+{
 	//While processes remain to be executed
 	while (processesRemaining)
 	{
+		//Snapshot the simulation, stopping here if this time slice is over
+		if (checkpoint_due() && !write_checkpoint(predictBursts ? "psrtf" : "srtf"))
+		{
+			return;
+		}
+
 		//If next event is an arrival
 		if (next_event()) // sets clock
 		{
@@ -398,38 +512,36 @@ void srtf()
 	} // end while
 
 	//Close out the last process
-	clock += processes[running].burstTime;
-	processes[running].endTime = clock;
+	simClock += processes.burstTime[running];
+	processes.endTime[running] = simClock;
 
 	//Calculate avg times and print to console
-	calc_times_and_print("Shortest Remaining Time First");
-} // end function srtf()
+	char label[64];
+	calc_times_and_print(prediction_label("Shortest Remaining Time First", label, sizeof(label)));
+} // end function run_srtf()
 
 int next_event()
 {
-	//Get next arrival time
-	int nextArriving = query_next_arrival();
-
-	//If last process already arrived
-	if (!nextArriving)
-	{
-		//Force next event to always be runner's end time
-		nextArriving = MAX_TIME;
-	}
+	//Get next arrival time, if any process is still to arrive
+	SimTime nextArriving;
+	int arrivalPending = query_next_arrival(&nextArriving);
 
 	//If runner is alive and will end before new arrival
-	if (!processes[running].flag && ((clock + processes[running].burstTime) < nextArriving))
+	if (!processes.flag[running] && (!arrivalPending || (simClock + processes.burstTime[running]) < nextArriving))
 	{
 		//Set clock to runner's end time
-		clock += processes[running].burstTime;
+		simClock += processes.burstTime[running];
 		return 0;
 	}
-	else // new arrival occurs earlier
+	else if (arrivalPending) // new arrival occurs earlier
 	{
 		//Set clock to next process's arrival time
-		clock = nextArriving;
+		simClock = nextArriving;
 		return 1;
 	}
+
+	//Runner is done and nothing is left to arrive
+	return 0;
 } // end function next_event()
 
 void add_arrivals()
@@ -442,13 +554,13 @@ void add_arrivals()
 		if (running != i)
 		{
 			//If this process has not already ended
-			if (processes[i].flag != -1)
+			if (processes.flag[i] != -1)
 			{
 				//If this process has arrived
-				if (processes[i].arrivalTime <= clock)
+				if (processes.arrivalTime[i] <= simClock)
 				{
-					//Add it to the waiting list
-					send_to_waiting(&processes[i]);
+					//Add it to the waiting list, if there's room
+					admit_to_waiting(i);
 				} // end if
 			} // end for
 		} // end if
@@ -472,7 +584,8 @@ void fork_srtf()
 	while (next != NULL)
 	{
 		//Start their wait time
-		next->data->beginWaiting = clock;
+		processes.beginWaiting[next->pid] = simClock;
+		processes.waiting[next->pid] = 1;
 		next = next->next;
 	}
 } // end function fork_srtf()
@@ -480,63 +593,51 @@ void fork_srtf()
 void running_to_waiting()
 {
 	//If runner is NOT finished
-	if (!processes[running].flag)
+	if (!processes.flag[running])
 	{
 		//Save runner's wait time and add runner to the waiting list
-		processes[running].beginWaiting = clock;
-		send_to_waiting(&processes[running]);
+		processes.beginWaiting[running] = simClock;
+		processes.waiting[running] = 1;
+		send_to_waiting(running);
 	}
 } // end function running_to_waiting()
 
 void waiting_to_running()
 {
 	//Save new runner, set its start time, and remove it from the list
-	running = waitingList.first->data->pid;
+	running = waitingList.first->pid;
 
 	//If runner hasn't already started
-	if (!processes[running].startTime)
+	if (!processes.started[running])
 	{
-		processes[running].startTime = clock;
-	}
-	else // process has been waiting
-	{
-		processes[running].latestStartTime = clock;
+		processes.startTime[running] = simClock;
+		processes.started[running] = 1;
 	}
+
+	//Either way, a new run segment begins now
+	processes.latestStartTime[running] = simClock;
 	
-	pop_front(&waitingList);
+	release_node(pop_front(&waitingList));
 } // end function waiting_to_running()
 
 int process_interrupt()
 {
-	int currBurst = 0;
-	int remainingBurst = 0;
-
-	//If runner never had to wait, use startTime
-	if (!processes[running].latestStartTime)
-	{
-		//For the amount of burst time the runner has completed
-		currBurst = (clock - processes[running].startTime);
-	}
-	else // runner waited, use latestStartTime
-	{
-		//For the amount of burst time the runner has completed
-		currBurst = (clock - processes[running].latestStartTime);
-	}
-
-	//Subtract it from runner's total burst time
-	remainingBurst = (processes[running].burstTime - currBurst);
+	SimTime remainingBurst = get_remaining_burst();
 
 	//If the runner is NOT finished
 	if (remainingBurst)
 	{
-		//Save runner's remaining burst time
-		processes[running].burstTime = remainingBurst;
+		//Save runner's remaining burst time, and count its estimate down by what it ran
+		SimTime ran = processes.burstTime[running] - remainingBurst;
+		processes.burstTime[running] = remainingBurst;
+		processes.predicted[running] = (processes.predicted[running] > ran) ? (processes.predicted[running] - ran) : 0;
 
 		//If the runner needs less time than the new comer
-		if (remainingBurst < waitingList.first->data->burstTime)
+		SimTime* key = burst_keys();
+		if (key[running] < key[waitingList.first->pid])
 		{
 			//Runner continues to run
-			processes[running].latestStartTime = clock;
+			processes.latestStartTime[running] = simClock;
 			return 0;
 		}
 		else // new comer needs less time
@@ -555,21 +656,22 @@ int process_interrupt()
 void runner_complete()
 {
 	//End running process
-	processes[running].endTime = clock;
-	processes[running].flag = -1;
+	processes.endTime[running] = simClock;
+	processes.flag[running] = -1;
 	processesRemaining--;
 } // end function runner_complete()
 
-int query_next_arrival()
+int query_next_arrival(SimTime* arrival)
 {
 	//For every process after the runner
 	int i;
-	for (i = (processes[running].pid + 1); i < numProcesses; i++)
+	for (i = (running + 1); i < numProcesses; i++)
 	{
 		//If the processes isn't dead
-		if (!processes[i].flag && !processes[i].beginWaiting)
+		if (!processes.flag[i] && !processes.waiting[i])
 		{
-			return processes[i].arrivalTime;
+			*arrival = processes.arrivalTime[i];
+			return 1;
 		}
 	} // end for
 
@@ -580,14 +682,16 @@ void force_start()
 {
 	//For every process after the runner
 	int i;
-	for (i = (processes[running].pid + 1); i < numProcesses; i++)
+	for (i = (running + 1); i < numProcesses; i++)
 	{
 		//If the processes isn't dead
-		if (!processes[i].flag)
+		if (!processes.flag[i])
 		{
-			running = processes[i].pid;
-			processes[running].startTime = processes[running].arrivalTime;
-			clock = processes[running].startTime;
+			running = i;
+			processes.startTime[running] = processes.arrivalTime[running];
+			processes.latestStartTime[running] = processes.startTime[running];
+			processes.started[running] = 1;
+			simClock = processes.startTime[running];
 			return;
 		}
 	} // end for
@@ -599,29 +703,55 @@ void update_srtf()
 	int i;
 	for (i = 0; i < numProcesses; i++)
 	{
-		if (processes[i].flag != -1)
+		if (processes.flag[i] != -1)
 		{
-			if (processes[i].beginWaiting != 0)
+			if (processes.waiting[i])
 			{
-				processes[i].waitTime += (clock - processes[i].beginWaiting);
-				processes[i].beginWaiting = 0;
+				processes.waitTime[i] += (simClock - processes.beginWaiting[i]);
+				processes.waiting[i] = 0;
 			}
 		} // end if
 	} // end for
 } // end function update_srtf()
 
-void send_to_waiting(Process* process)
+void send_to_waiting(int pid)
 {
-	Node* node = malloc(sizeof(Node));
-	node_param_constructor(node, process);
+	Node* node = acquire_node(pid);
+	int count = waitingList.count;
 	push_back(&waitingList, node);
+
+	//Duplicates are turned away, so take the node back
+	if (waitingList.count == count)
+	{
+		release_node(node);
+	}
 } // end function send_to_waiting()
 
+Node* acquire_node(int pid)
+{
+	//Reuse a spare node if there is one
+	Node* node = pop_front(&spareNodes);
+	if (node == NULL)
+	{
+		node = malloc(sizeof(Node));
+	}
+
+	node_param_constructor(node, pid);
+	return node;
+} // end function acquire_node()
+
+void release_node(Node* node)
+{
+	node->next = NULL;
+	push_front(&spareNodes, node);
+} // end function release_node()
+
 void sort_list_burst()
 {
 	int killSwitch;
 	Node* rPtr = NULL;
 	Node* lPtr = NULL;
+	SimTime* key = burst_keys();
 
 	//If list is empty
 	if (waitingList.count)
@@ -634,12 +764,12 @@ void sort_list_burst()
 			while (rPtr->next != lPtr)
 			{
 				//If bigger comes before smaller
-				if (rPtr->data->burstTime > rPtr->next->data->burstTime)
+				if (key[rPtr->pid] > key[rPtr->next->pid])
 				{
 					//Swap
-					Process* temp = rPtr->data;
-					rPtr->data = rPtr->next->data;
-					rPtr->next->data = temp;
+					int temp = rPtr->pid;
+					rPtr->pid = rPtr->next->pid;
+					rPtr->next->pid = temp;
 
 					killSwitch = 1;
 				} // end if
@@ -652,18 +782,39 @@ void sort_list_burst()
 	} // end if
 } // end function sort_list_burst()
 
+SimTime* burst_keys()
+{
+	//What sjf and srtf order by: the bursts themselves, or what a real scheduler would guess
+	return predictBursts ? processes.predicted : processes.burstTime;
+} // end function burst_keys()
+
 //***************************************************************************ROUND ROBIN
 
 void rr()
 {
 	//Initialize runner
-	running = processes[0].pid;
-	processes[0].startTime = processes[0].arrivalTime;
-	clock = processes[0].startTime;
+	running = 0;
+	processes.startTime[0] = processes.arrivalTime[0];
+	processes.latestStartTime[0] = processes.startTime[0];
+	processes.started[0] = 1;
+	simClock = processes.startTime[0];
+	start_slice(0);
+
+	run_rr();
+} // end function rr()
 
+void run_rr()
+{
 	//While processes remain to be executed
+	SimTime nextArriving;
 	while (processesRemaining)
 	{
+		//Snapshot the simulation, stopping here if this time slice is over
+		if (checkpoint_due() && !write_checkpoint(adaptiveQuantum ? "arr" : "rr"))
+		{
+			return;
+		}
+
 		//If next event is an arrival
 		if (next_event_rr()) // sets clock
 		{
@@ -678,10 +829,10 @@ void rr()
 		{
 			fork_rr(); // switches runner, begins waiting
 		}
-		else if (query_next_arrival() > (get_relative_start() + processes[running].burstTime))
+		else if (query_next_arrival(&nextArriving) && nextArriving > (get_relative_start() + processes.burstTime[running]))
 		{
 			//runner_complete();
-			if (processes[running].flag == -1)
+			if (processes.flag[running] == -1)
 			{
 				force_start();
 			}
@@ -689,58 +840,53 @@ void rr()
 	} // end while
 
 	//Close out the last process
-	clock += processes[running].burstTime;
-	processes[running].endTime = clock;
+	simClock += processes.burstTime[running];
+	processes.endTime[running] = simClock;
 
 	//Calculate avg times and print to console
-	calc_times_and_print("Round Robin (w/ quantum 100)");
-} // end function rr()
+	char label[64];
+	calc_times_and_print(adaptive_label(label, sizeof(label)));
+} // end function run_rr()
 
 int next_event_rr()
 {
-	//Get next arrival time
-	int nextArriving = query_next_arrival();
-
-	//If last process already arrived
-	if (!nextArriving)
-	{
-		//Force next event to always be runner's end time
-		nextArriving = MAX_TIME;
-	}
+	//Get next arrival time, if any process is still to arrive
+	SimTime nextArriving;
+	int arrivalPending = query_next_arrival(&nextArriving);
 
 	//If runner will end before quantum
-	int temp = processes[running].remainingQuantum; // for readability
-	if (processes[running].burstTime <= temp)
+	SimTime temp = processes.remainingQuantum[running]; // for readability
+	if (processes.burstTime[running] <= temp)
 	{
 		//But an arrival will occur before that
-		if (nextArriving < (clock + processes[running].burstTime))
+		if (arrivalPending && nextArriving < (simClock + processes.burstTime[running]))
 		{
 			//Save runner's remaining quantum and jump to next arrival
-			processes[running].remainingQuantum = (temp - (nextArriving - clock));
-			clock = nextArriving;
+			processes.remainingQuantum[running] = (temp - (nextArriving - simClock));
+			simClock = nextArriving;
 			return 1;
 		}
 		else // end runner
 		{
 			//Set clock to runner's end time
-			clock += processes[running].burstTime;
+			simClock += processes.burstTime[running];
 			runner_complete();
 			return 0;
 		}
 	} // end if
-	else if (nextArriving <= (clock + temp))
+	else if (arrivalPending && nextArriving <= (simClock + temp))
 	{
 		//Save runner's remaining quantum and jump to next arrival
-		processes[running].remainingQuantum = (temp - (nextArriving - clock));
-		clock = nextArriving;
+		processes.remainingQuantum[running] = (temp - (nextArriving - simClock));
+		simClock = nextArriving;
 		return 1;
 	}
 
 	//Runner's burst exceeds quantum
-	clock += temp;
-	processes[running].remainingQuantum = QUANTUM; 
-	processes[running].burstTime = get_remaining_burst();
-	processes[running].latestStartTime = clock;
+	simClock += temp;
+	renew_slice(running);
+	processes.burstTime[running] = get_remaining_burst();
+	processes.latestStartTime[running] = simClock;
 	
 	return 0;
 } // end function next_event_rr()
@@ -755,13 +901,13 @@ void add_arrivals_rr()
 		if (running != i)
 		{
 			//If this process has not already ended
-			if (processes[i].flag != -1)
+			if (processes.flag[i] != -1)
 			{
 				//If this process has arrived
-				if (processes[i].arrivalTime <= clock)
+				if (processes.arrivalTime[i] <= simClock)
 				{
-					//Add it to the waiting list
-					send_to_waiting(&processes[i]);
+					//Add it to the waiting list, if there's room
+					admit_to_waiting(i);
 				} // end if
 			} // end for
 		} // end if
@@ -782,26 +928,28 @@ void fork_rr()
 	while (next != NULL)
 	{
 		//Start their wait time
-		next->data->beginWaiting = clock;
+		processes.beginWaiting[next->pid] = simClock;
+		processes.waiting[next->pid] = 1;
 		next = next->next;
 	}
 } // end function fork_rr()
 
 int process_interrupt_rr()
 {
-	int remainingBurst = get_remaining_burst();
+	SimTime remainingBurst = get_remaining_burst();
 
 	//If the runner is NOT finished
 	if (remainingBurst)
 	{
 		//Save runner's remaining burst time
-		processes[running].burstTime = remainingBurst;
+		processes.burstTime[running] = remainingBurst;
 
-		//If runner has quantum left, but is not about to start a full new one
-		if (processes[running].remainingQuantum != 0 && processes[running].remainingQuantum != QUANTUM)
+		//If runner has quantum left, but is not about to start a full new one (adaptive rr
+		//leaves none when a slice is up and the runner should yield)
+		if (processes.remainingQuantum[running] != 0 && (adaptiveQuantum || processes.remainingQuantum[running] != quantum))
 		{
 			//Runner continues to run
-			processes[running].latestStartTime = clock;
+			processes.latestStartTime[running] = simClock;
 			return 0;
 		}
 		else // runner's time is up
@@ -812,7 +960,7 @@ int process_interrupt_rr()
 	} // end if
 	else // runner is done
 	{
-		if (processes[running].flag != -1)
+		if (processes.flag[running] != -1)
 		{
 			runner_complete();
 		}
@@ -820,58 +968,634 @@ int process_interrupt_rr()
 	}
 } // end function process_interrupt_rr()
 
-int get_remaining_burst()
+SimTime get_remaining_burst()
+{
+	//For the amount of burst time the runner has completed in this run segment
+	SimTime currBurst = (simClock - get_relative_start());
+
+	//Subtract it from runner's total burst time
+	return (processes.burstTime[running] - currBurst);
+} // end function get_remaining_burst()
+
+SimTime get_relative_start()
+{
+	//Every dispatch stamps the start of the runner's current run segment
+	return processes.latestStartTime[running];
+} // end function get_relative_start()
+
+void waiting_to_running_rr()
+{
+	//Save new runner
+	running = waitingList.first->pid;
+
+	//If runner hasn't already started
+	if (!processes.started[running])
+	{
+		processes.startTime[running] = simClock;
+		processes.started[running] = 1;
+	}
+
+	//Either way, a new run segment begins now
+	processes.latestStartTime[running] = simClock;
+	contextSwitches++;
+
+	release_node(pop_front(&waitingList));
+	start_slice(running);
+} // end function waiting_to_running_rr()
+
+//***************************************************************************PROPORTIONAL SHARE
+
+void lottery()
 {
-	int currBurst = 0;
-	int remainingBurst = 0;
+	//Build an empty ticket index
+	reserve_share(numProcesses);
+	memset(fenwick, 0, sizeof(long long) * (numProcesses + 1));
+	totalTickets = 0;
 
-	//If runner never had to wait, use startTime
-	if (!processes[running].latestStartTime)
+	char label[64];
+	snprintf(label, sizeof(label), "Lottery (w/ quantum %" PRId64 ")", quantum);
+	run_share(label, &lotteryPolicy);
+} // end function lottery()
+
+void stride()
+{
+	//Build an empty run queue
+	reserve_share(numProcesses);
+	memset(pass, 0, sizeof(long long) * numProcesses);
+	heapCount = 0;
+	globalPass = 0;
+
+	char label[64];
+	snprintf(label, sizeof(label), "Stride (w/ quantum %" PRId64 ")", quantum);
+	run_share(label, &stridePolicy);
+} // end function stride()
+
+void run_share(char* algorithmType, const P5Policy* policy)
+{
+	//Reset per process bookkeeping
+	reserve_share(numProcesses);
+	memset(shareService, 0, sizeof(SimTime) * numProcesses);
+	shareCount = 0;
+	totalWeight = 0;
+	virtualTime = 0;
+
+	//Spread the samples over the span of the run unless told otherwise
+	int i;
+	SimTime totalBurst = 0;
+	for (i = 0; i < numProcesses; i++)
 	{
-		//For the amount of burst time the runner has completed
-		currBurst = (clock - processes[running].startTime);
+		remainingBurst[i] = processes.burstTime[i];
+		shareSlot[i] = -1;
+		totalBurst += processes.burstTime[i];
 	}
-	else // runner waited, use latestStartTime
+	SimTime interval = shareInterval;
+	if (interval <= 0)
 	{
-		//For the amount of burst time the runner has completed
-		currBurst = (clock - processes[running].latestStartTime);
+		interval = (totalBurst / SHARE_SAMPLES);
+		interval = (interval > 0) ? interval : 1;
 	}
 
-	//Subtract it from runner's total burst time
-	remainingBurst = (processes[running].burstTime - currBurst);
+	//The policy's state for this run
+	P5PolicyEnv env = { P5_POLICY_ABI, numProcesses, quantum, randomState };
+	void* state = (policy->init != NULL) ? policy->init(&env) : NULL;
 
-	return remainingBurst;
-} // end function get_remaining_burst()
+	//Start the clock at the first arrival
+	simClock = processes.arrivalTime[0];
+	nextShareSample = simClock + interval;
+	nextArrival = 0;
+	admit_arrivals_share(policy, state);
+
+	if (!quiet)
+	{
+		printf("\n%s:\n", algorithmType);
+		printf("\tShare Gap Over Time (time, max |lag|, mean |lag|):\n");
+	}
+
+	//While processes remain to be executed
+	int completed = 0;
+	while (completed < numProcesses)
+	{
+		//If nothing is runnable, jump to the next arrival
+		if (!shareCount)
+		{
+			simClock = processes.arrivalTime[nextArrival];
+			admit_arrivals_share(policy, state);
+			continue;
+		}
+
+		//Select and run a process for one quantum, or less if it finishes first
+		SimTime slice = quantum;
+		int pid = policy->pick_next(state, simClock, &slice);
+		slice = (slice > 0) ? slice : 1;
+
+		//Everything runnable is held back, so idle until it's released or something arrives
+		if (pid < 0)
+		{
+			SimTime idleFrom = simClock;
+			simClock = (slice < INT64_MAX - simClock) ? (simClock + slice) : INT64_MAX;
+			if (nextArrival < numProcesses && processes.arrivalTime[nextArrival] < simClock)
+			{
+				simClock = processes.arrivalTime[nextArrival];
+			}
+			telemetry_idle(idleFrom, simClock);
+			admit_arrivals_share(policy, state);
+			continue;
+		}
+
+		//A plugin can only run what's runnable
+		if (pid >= numProcesses || shareSlot[pid] < 0)
+		{
+			fprintf(stderr, "%s picked job %d, which isn't runnable\n", policy->name, pid);
+			exit(1);
+		}
+
+		SimTime ran = (remainingBurst[pid] < slice) ? remainingBurst[pid] : slice;
+
+		//If this is the process's first time on the cpu
+		if (remainingBurst[pid] == processes.burstTime[pid])
+		{
+			processes.startTime[pid] = simClock;
+		}
+
+		//Every runnable process is owed its weighted share of the slice
+		virtualTime += (double)ran / totalWeight;
+		shareService[pid] += ran;
+		remainingBurst[pid] -= ran;
+		simClock += ran;
+
+		//Processes arriving during the slice compete from its end
+		admit_arrivals_share(policy, state);
+
+		//If the process is finished
+		if (!remainingBurst[pid])
+		{
+			processes.endTime[pid] = simClock;
+			processes.waitTime[pid] = (simClock - processes.arrivalTime[pid] - processes.burstTime[pid]);
+			policy->on_complete(state, pid, ran);
+			share_leave(pid);
+			completed++;
+		}
+		else // process goes back in line
+		{
+			policy->on_preempt(state, pid, ran);
+		}
 
-int get_relative_start()
+		//Report the share gap at every sampling point crossed
+		while (simClock >= nextShareSample)
+		{
+			sample_share_gap();
+			nextShareSample += interval;
+		}
+	} // end while
+
+	if (policy->fini != NULL)
+	{
+		policy->fini(state);
+	}
+
+	//Calculate avg times and print to console
+	calc_times_and_print(NULL);
+} // end function run_share()
+
+void reserve_share(int count)
 {
-	if (processes[running].latestStartTime)
+	//Buffers only ever grow, so a warm thread reuses them run after run
+	if (count <= shareCapacity)
 	{
-		return processes[running].latestStartTime;
+		return;
 	}
-	else
+
+	fenwick = realloc(fenwick, sizeof(long long) * (count + 1));
+	strideHeap = realloc(strideHeap, sizeof(int) * count);
+	pass = realloc(pass, sizeof(long long) * count);
+	remainingBurst = realloc(remainingBurst, sizeof(SimTime) * count);
+	shareSlot = realloc(shareSlot, sizeof(int) * count);
+	shareActive = realloc(shareActive, sizeof(int) * count);
+	shareJoined = realloc(shareJoined, sizeof(double) * count);
+	shareService = realloc(shareService, sizeof(SimTime) * count);
+	shareCapacity = count;
+} // end function reserve_share()
+
+void admit_arrivals_share(const P5Policy* policy, void* state)
+{
+	//Arrival times are sorted, so only the next process yet to arrive needs checking
+	while (nextArrival < numProcesses && processes.arrivalTime[nextArrival] <= simClock)
 	{
-		return processes[running].startTime;
+		share_join(nextArrival, policy, state);
+		nextArrival++;
 	}
-} // end function get_relative_start()
+} // end function admit_arrivals_share()
 
-void waiting_to_running_rr()
+void share_join(int pid, const P5Policy* policy, void* state)
 {
-	//Save new runner
-	running = waitingList.first->data->pid;
+	//Track the process for share gap sampling
+	shareSlot[pid] = shareCount;
+	shareActive[shareCount++] = pid;
+	shareJoined[pid] = virtualTime;
+	totalWeight += processes.weight[pid];
+
+	P5PolicyJob job = { processes.arrivalTime[pid], processes.burstTime[pid], processes.weight[pid],
+			processes.task[pid], processes.group[pid], processes.deadline[pid] };
+	policy->on_arrival(state, pid, &job);
+} // end function share_join()
+
+void share_leave(int pid)
+{
+	//Swap the last runnable process into the vacated slot
+	int last = shareActive[--shareCount];
+	shareActive[shareSlot[pid]] = last;
+	shareSlot[last] = shareSlot[pid];
+	shareSlot[pid] = -1;
+	totalWeight -= processes.weight[pid];
+} // end function share_leave()
+
+void sample_share_gap()
+{
+	//Nobody to report to
+	if (quiet)
+	{
+		return;
+	}
 
-	//If runner hasn't already started
-	if (!processes[running].startTime)
+	double maxLag = 0;
+	double sumLag = 0;
+
+	//For every runnable process
+	int i;
+	for (i = 0; i < shareCount; i++)
+	{
+		//Lag is the service it was owed minus the service it got
+		int pid = shareActive[i];
+		double owed = processes.weight[pid] * (virtualTime - shareJoined[pid]);
+		double lag = owed - shareService[pid];
+		lag = (lag < 0) ? -lag : lag;
+
+		sumLag += lag;
+		maxLag = (lag > maxLag) ? lag : maxLag;
+	} // end for
+
+	printf("\t\t%" PRId64 "\t%.2f\t%.2f\n", simClock, maxLag, shareCount ? (sumLag / shareCount) : 0);
+} // end function sample_share_gap()
+
+unsigned long long next_random()
+{
+	//xorshift64*
+	randomState ^= randomState >> 12;
+	randomState ^= randomState << 25;
+	randomState ^= randomState >> 27;
+	return randomState * 2685821657736338717ULL;
+} // end function next_random()
+
+//***************************************************************************LOTTERY
+
+void join_lottery(void* state, int pid, const P5PolicyJob* job)
+{
+	fenwick_add(pid + 1, processes.weight[pid]);
+	totalTickets += processes.weight[pid];
+} // end function join_lottery()
+
+int pick_lottery(void* state, int64_t now, int64_t* slice)
+{
+	//Draw a ticket and find its holder
+	long long ticket = (long long)(next_random() % (unsigned long long)totalTickets);
+	return fenwick_find(ticket);
+} // end function pick_lottery()
+
+void requeue_lottery(void* state, int pid, int64_t ran)
+{
+	//Winner keeps its tickets in the drum
+} // end function requeue_lottery()
+
+void leave_lottery(void* state, int pid, int64_t ran)
+{
+	fenwick_add(pid + 1, -processes.weight[pid]);
+	totalTickets -= processes.weight[pid];
+} // end function leave_lottery()
+
+void fenwick_add(int index, long long delta)
+{
+	//Walk up the tree updating every range covering index
+	for (; index <= numProcesses; index += (index & -index))
 	{
-		processes[running].startTime = clock;
+		fenwick[index] += delta;
 	}
-	else // process has been waiting
+} // end function fenwick_add()
+
+int fenwick_find(long long ticket)
+{
+	//Find the highest power of two within the tree
+	int step = 1;
+	while ((step << 1) <= numProcesses)
 	{
-		processes[running].latestStartTime = clock;
+		step <<= 1;
 	}
 
-	pop_front(&waitingList);
-} // end function waiting_to_running_rr()
+	//Descend, skipping ranges whose tickets all fall below the drawn one
+	int index = 0;
+	for (; step; step >>= 1)
+	{
+		if (index + step <= numProcesses && fenwick[index + step] <= ticket)
+		{
+			index += step;
+			ticket -= fenwick[index];
+		}
+	} // end for
+
+	//Index is the count of processes wholly below the ticket, so the holder is next
+	return index;
+} // end function fenwick_find()
+
+//***************************************************************************STRIDE
+
+void join_stride(void* state, int pid, const P5PolicyJob* job)
+{
+	//Newcomers start level with the current pass, so they can't monopolize the cpu
+	pass[pid] = globalPass;
+	heap_push(pid);
+} // end function join_stride()
+
+int pick_stride(void* state, int64_t now, int64_t* slice)
+{
+	int pid = heap_pop();
+	globalPass = pass[pid];
+	return pid;
+} // end function pick_stride()
+
+void requeue_stride(void* state, int pid, int64_t ran)
+{
+	//Advance pass in proportion to the slice actually used
+	pass[pid] += ((long long)(STRIDE1 / processes.weight[pid]) * ran) / quantum;
+	heap_push(pid);
+} // end function requeue_stride()
+
+void leave_stride(void* state, int pid, int64_t ran)
+{
+	//Finished process was already popped from the run queue
+} // end function leave_stride()
+
+void heap_push(int pid)
+{
+	//Sift the new entry up from the bottom
+	int i = heapCount++;
+	while (i > 0 && heap_less(pid, strideHeap[(i - 1) / 2]))
+	{
+		strideHeap[i] = strideHeap[(i - 1) / 2];
+		i = (i - 1) / 2;
+	}
+	strideHeap[i] = pid;
+} // end function heap_push()
+
+int heap_pop()
+{
+	int top = strideHeap[0];
+	int last = strideHeap[--heapCount];
+
+	//Sift the last entry down from the top
+	int i = 0;
+	while ((2 * i) + 1 < heapCount)
+	{
+		int child = (2 * i) + 1;
+		if (child + 1 < heapCount && heap_less(strideHeap[child + 1], strideHeap[child]))
+		{
+			child++;
+		}
+
+		if (!heap_less(strideHeap[child], last))
+		{
+			break;
+		}
+
+		strideHeap[i] = strideHeap[child];
+		i = child;
+	} // end while
+	strideHeap[i] = last;
+
+	return top;
+} // end function heap_pop()
+
+int heap_less(int a, int b)
+{
+	//Order by pass, then by pid so ties break deterministically
+	if (pass[a] != pass[b])
+	{
+		return pass[a] < pass[b];
+	}
+	return a < b;
+} // end function heap_less()
+
+//***************************************************************************CHECKPOINT
+
+int checkpoint_due()
+{
+	return (checkpointInterval > 0 && simClock >= nextCheckpoint);
+} // end function checkpoint_due()
+
+int write_checkpoint(char* policyName)
+{
+	//What-if runs keep their snapshots in memory
+	if (whatIfMode)
+	{
+		return what_if_checkpoint();
+	}
+
+	//Only rows up to the last arrival can have progressed past their initial state
+	int horizon = 0;
+	while (horizon < numProcesses && processes.arrivalTime[horizon] <= simClock)
+	{
+		horizon++;
+	}
+
+	//Fill in the header
+	Checkpoint header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+	strncpy(header.policy, policyName, sizeof(header.policy) - 1);
+	header.fingerprint = workloadFingerprint;
+	header.numProcesses = numProcesses;
+	header.horizon = horizon;
+	header.clock = simClock;
+	header.running = running;
+	header.processesRemaining = processesRemaining;
+	header.waitingCount = waitingList.count;
+	header.contextSwitches = contextSwitches;
+	header.quantum = quantum;
+	header.randomState = randomState;
+	header.predictAlpha = predictAlpha;
+	header.predictInitial = predictInitial;
+	header.adaptiveMin = adaptiveMin;
+	header.adaptiveMax = adaptiveMax;
+	header.adaptiveLatency = adaptiveLatency;
+	header.queueCapacity = queueCapacity;
+	strncpy(header.admission, admission, sizeof(header.admission) - 1);
+	header.tickPeriod = tickPeriod;
+	header.tickCost = tickCost;
+	header.ticklessIdle = ticklessIdle;
+
+	//Write to a scratch file first, so a crash mid-write leaves the last snapshot intact
+	char scratch[4096];
+	snprintf(scratch, sizeof(scratch), "%s.tmp", checkpointPath);
+	FILE* file = fopen(scratch, "wb");
+	if (file == NULL)
+	{
+		perror(scratch);
+		exit(1);
+	}
+
+	fwrite(&header, sizeof(header), 1, file);
+
+	//Run queue, front to back
+	Node* next = waitingList.first;
+	while (next != NULL)
+	{
+		fwrite(&next->pid, sizeof(int), 1, file);
+		next = next->next;
+	}
+
+	//Per process progress, a column at a time
+#define WRITE_COLUMN(type, name) \
+	fwrite(processes.name, sizeof(type), horizon, file);
+	PROCESS_COLUMNS(WRITE_COLUMN)
+#undef WRITE_COLUMN
+
+	if (fclose(file) != 0 || rename(scratch, checkpointPath) != 0)
+	{
+		perror(checkpointPath);
+		exit(1);
+	}
+
+	//Schedule the next snapshot on the interval grid, so resumed runs keep the same pace
+	nextCheckpoint = ((simClock / checkpointInterval) + 1) * checkpointInterval;
+
+	//If this time slice is over, report where it stopped
+	if (stopTime >= 0 && simClock >= stopTime)
+	{
+		if (!quiet)
+		{
+			printf("\n%s:\n\tCheckpointed at time %" PRId64 " to %s\n", policyName, simClock, checkpointPath);
+		}
+		return 0;
+	}
+
+	return 1;
+} // end function write_checkpoint()
+
+Policy* read_checkpoint(char* path)
+{
+	FILE* file = fopen(path, "rb");
+	if (file == NULL)
+	{
+		perror(path);
+		exit(1);
+	}
+
+	//Check the snapshot belongs to this workload
+	Checkpoint header;
+	if (fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) != 0)
+	{
+		fprintf(stderr, "%s: not a checkpoint file\n", path);
+		exit(1);
+	}
+	if (header.fingerprint != workloadFingerprint || header.numProcesses != numProcesses)
+	{
+		fprintf(stderr, "%s: checkpoint was taken from a different workload\n", path);
+		exit(1);
+	}
+
+	Policy* policy = find_policy(header.policy);
+	if (policy == NULL || policy->resume == NULL)
+	{
+		fprintf(stderr, "%s: algorithm '%s' can't be resumed\n", path, header.policy);
+		exit(1);
+	}
+
+	//Restore the globals, finishing under the settings the run started with
+	char* shedding = find_admission(header.admission);
+	if (shedding == NULL)
+	{
+		fprintf(stderr, "%s: unknown admission policy '%.15s'\n", path, header.admission);
+		exit(1);
+	}
+	simClock = header.clock;
+	running = header.running;
+	processesRemaining = header.processesRemaining;
+	contextSwitches = header.contextSwitches;
+	quantum = header.quantum;
+	randomState = header.randomState;
+	predictAlpha = header.predictAlpha;
+	predictInitial = header.predictInitial;
+	adaptiveMin = header.adaptiveMin;
+	adaptiveMax = header.adaptiveMax;
+	adaptiveLatency = header.adaptiveLatency;
+	queueCapacity = header.queueCapacity;
+	admission = shedding;
+	tickPeriod = header.tickPeriod;
+	tickCost = header.tickCost;
+	ticklessIdle = header.ticklessIdle;
+
+	//Rows yet to arrive start from a slice and a guess made under the restored settings
+	int i;
+	for (i = 0; i < numProcesses; i++)
+	{
+		processes.remainingQuantum[i] = quantum;
+	}
+	predict_bursts();
+
+	//Rebuild the run queue
+	list_constructor(&waitingList);
+	for (i = 0; i < header.waitingCount; i++)
+	{
+		int pid;
+		if (fread(&pid, sizeof(int), 1, file) != 1)
+		{
+			fprintf(stderr, "%s: truncated checkpoint\n", path);
+			exit(1);
+		}
+		send_to_waiting(pid);
+	} // end for
+
+	//Restore per process progress
+	int ok = 1;
+#define READ_COLUMN(type, name) \
+	ok = ok && (fread(processes.name, sizeof(type), header.horizon, file) == (size_t)header.horizon);
+	PROCESS_COLUMNS(READ_COLUMN)
+#undef READ_COLUMN
+	if (!ok)
+	{
+		fprintf(stderr, "%s: truncated checkpoint\n", path);
+		exit(1);
+	}
+
+	fclose(file);
+
+	//Carry on snapshotting at the same pace
+	if (checkpointInterval > 0)
+	{
+		nextCheckpoint = ((simClock / checkpointInterval) + 1) * checkpointInterval;
+	}
+
+	return policy;
+} // end function read_checkpoint()
+
+unsigned long long fingerprint_workload()
+{
+	//FNV-1a over every arrival, burst time, weight, group, deadline and task, then the groups' settings
+	unsigned long long hash = 14695981039346656037ULL;
+	int i;
+	for (i = 0; i < numProcesses; i++)
+	{
+		SimTime values[6] = { processes.arrivalTime[i], processes.burstTime[i], processes.weight[i], processes.group[i], processes.deadline[i], processes.task[i] };
+		unsigned char* bytes = (unsigned char*)values;
+
+		size_t b;
+		for (b = 0; b < sizeof(values); b++)
+		{
+			hash ^= bytes[b];
+			hash *= 1099511628211ULL;
+		}
+	} // end for
+
+	return fingerprint_groups(hash);
+} // end function fingerprint_workload()
 
 //***************************************************************************OTHER
 
@@ -880,74 +1604,382 @@ void init_all()
 	//Initialize globals
 	processesRemaining = (numProcesses - 1);
 	running = 0;
-	clock = 0;
+	simClock = 0;
+	idleCount = 0;
+	contextSwitches = 0;
 
-	//Free memory
-	list_destructor(&waitingList);
+	//Recycle anything left on the wait list
+	Node* node;
+	while ((node = pop_front(&waitingList)) != NULL)
+	{
+		release_node(node);
+	}
 
 	//Set quantum value for each process struct
 	int i;
 	for (i = 0; i < numProcesses; i++)
 	{
-		processes[i].remainingQuantum = QUANTUM;
+		processes.remainingQuantum[i] = quantum;
 	}
 } // end function init_all()
 
 void calc_times_and_print(char* algorithmType)
 {
-	//Declare locals
-	double sumResponseTime = 0;
-	double sumTurnTime = 0;
-	double sumWaitTime = 0;
+	//A split run has only its last span here, so gather the others first
+	if (splitPending)
+	{
+		gather_spans();
+	}
 
-	//For every process
-	int i;
-	for (i = 0; i < numProcesses; i++)
+	//Declare locals, wide enough to sum a day of nanoseconds per process exactly
+	long double sumResponseTime = 0;
+	long double sumTurnTime = 0;
+	long double sumWaitTime = 0;
+	Metrics metrics = { { 0 }, { INT64_MAX, INT64_MAX, INT64_MAX }, { INT64_MIN, INT64_MIN, INT64_MIN } };
+	memset(summary.turnHistogram, 0, sizeof(summary.turnHistogram));
+
+	//Shed jobs never ran, so with a bounded run queue only the admitted ones are measured
+	SimTime* arrival = processes.arrivalTime;
+	SimTime* start = processes.startTime;
+	SimTime* end = processes.endTime;
+	SimTime* wait = processes.waitTime;
+	SimTime* admitted = NULL;
+	int rows = numProcesses;
+	summary.shedJobs = 0;
+	if (queueCapacity > 0)
+	{
+		admitted = malloc(sizeof(SimTime) * 4 * numProcesses);
+		rows = gather_admitted(admitted);
+		arrival = admitted;
+		start = admitted + numProcesses;
+		end = admitted + (2 * numProcesses);
+		wait = admitted + (3 * numProcesses);
+		summary.shedJobs = numProcesses - rows;
+		summary.p99TurnTime = to_output_unit(admitted_p99(arrival, end, rows));
+	}
+
+	//A block at a time: exact 64 bit sums, so the wide totals and the averages come out
+	//the same as adding row by row, then the histogram while the block is still in cache
+	int first;
+	for (first = 0; first < rows; first += METRIC_BLOCK)
 	{
-		//Add up their response, turnaround, and wait times
-		sumResponseTime += (processes[i].startTime - processes[i].arrivalTime);
-		sumTurnTime += (processes[i].endTime - processes[i].arrivalTime);
-		sumWaitTime += processes[i].waitTime;
-
-		// processes[i].responseTime = (processes[i].startTime - processes[i].arrivalTime);
-		// processes[i].turnTime = (processes[i].endTime - processes[i].arrivalTime);
-
-		// printf("Process: %d\n"
-		// 	"\tArrival Time: %d\n"
-		// 	"\tStart Time: %d\n"
-		// 	"\tEnd Time: %d\n"
-		// 	"\tResponse Time: %d\n"
-		// 	"\tTurn Time: %d\n"
-		// 	"\tWait Time: %d\n"
-		// 	, i, processes[i].arrivalTime, 
-		// 	processes[i].startTime, 
-		// 	processes[i].endTime, 
-		// 	processes[i].responseTime, 
-		// 	processes[i].turnTime, 
-		// 	processes[i].waitTime);
+		int count = rows - first;
+		if (count >= METRIC_BLOCK)
+		{
+			count = METRIC_BLOCK;
+			reduce_block(&arrival[first], &start[first], &end[first], &wait[first], &metrics);
+		}
+		else
+		{
+			reduce_rows(count, &arrival[first], &start[first], &end[first], &wait[first], &metrics);
+		}
+
+		sumResponseTime += metrics.sum[0];
+		sumTurnTime += metrics.sum[1];
+		sumWaitTime += metrics.sum[2];
+
+		int i;
+		for (i = first; i < first + count; i++)
+		{
+			unsigned long long turnTime = (unsigned long long)(end[i] - arrival[i]);
+			summary.turnHistogram[turnTime ? (64 - __builtin_clzll(turnTime)) : 0]++;
+		}
 	} // end for
+	free(admitted);
 
 	  //Calculate avg times
-	double avgResponseTime = (sumResponseTime / numProcesses);
-	double avgTurnTime = (sumTurnTime / numProcesses);
-	double avgWaitTime = (sumWaitTime / numProcesses);
+	double avgResponseTime = (double)(sumResponseTime / rows);
+	double avgTurnTime = (double)(sumTurnTime / rows);
+	double avgWaitTime = (double)(sumWaitTime / rows);
+
+	//Convert to the reporting unit, if the workload declared one
+	avgResponseTime = to_output_unit(avgResponseTime);
+	avgTurnTime = to_output_unit(avgTurnTime);
+	avgWaitTime = to_output_unit(avgWaitTime);
+
+	//Keep the averages for library callers
+	summary.responseTime = avgResponseTime;
+	summary.turnTime = avgTurnTime;
+	summary.waitTime = avgWaitTime;
+	summary.minResponseTime = to_output_unit(metrics.min[0]);
+	summary.maxResponseTime = to_output_unit(metrics.max[0]);
+	summary.minTurnTime = to_output_unit(metrics.min[1]);
+	summary.maxTurnTime = to_output_unit(metrics.max[1]);
+	summary.minWaitTime = to_output_unit(metrics.min[2]);
+	summary.maxWaitTime = to_output_unit(metrics.max[2]);
 
 	//Print result to console
-	print(algorithmType, avgResponseTime, avgTurnTime, avgWaitTime);
+	if (!quiet)
+	{
+		print(algorithmType, avgResponseTime, avgTurnTime, avgWaitTime);
+
+		if (showSpread)
+		{
+			print_spread();
+		}
+
+		if (queueCapacity > 0)
+		{
+			print_admission();
+		}
+
+		if (predictBursts)
+		{
+			print_prediction();
+		}
+
+		if (adaptiveQuantum)
+		{
+			print_adaptive();
+		}
+
+		//The bounds are for every job of the workload as read, on one cpu
+		if (showGap && !summary.shedJobs && !coreCount && !whatIfMode)
+		{
+			print_gap();
+		}
+	}
 } // end function calc_times_and_print()
 
+//Inlined into both callers, so the full block version is compiled for a constant count
+static inline __attribute__((always_inline)) void reduce(int count, SimTime* arrival, SimTime* start, SimTime* end, SimTime* wait, Metrics* metrics)
+{
+	//Separate accumulators per metric, so each one becomes a vector lane
+	SimTime sumResponse = 0;
+	SimTime sumTurn = 0;
+	SimTime sumWait = 0;
+	SimTime minResponse = metrics->min[0];
+	SimTime minTurn = metrics->min[1];
+	SimTime minWait = metrics->min[2];
+	SimTime maxResponse = metrics->max[0];
+	SimTime maxTurn = metrics->max[1];
+	SimTime maxWait = metrics->max[2];
+
+	int i;
+	for (i = 0; i < count; i++)
+	{
+		SimTime response = start[i] - arrival[i];
+		SimTime turn = end[i] - arrival[i];
+		SimTime waited = wait[i];
+
+		sumResponse += response;
+		sumTurn += turn;
+		sumWait += waited;
+		minResponse = (response < minResponse) ? response : minResponse;
+		maxResponse = (response > maxResponse) ? response : maxResponse;
+		minTurn = (turn < minTurn) ? turn : minTurn;
+		maxTurn = (turn > maxTurn) ? turn : maxTurn;
+		minWait = (waited < minWait) ? waited : minWait;
+		maxWait = (waited > maxWait) ? waited : maxWait;
+	} // end for
+
+	//Sums are per block, the extremes carry over
+	metrics->sum[0] = sumResponse;
+	metrics->sum[1] = sumTurn;
+	metrics->sum[2] = sumWait;
+	metrics->min[0] = minResponse;
+	metrics->min[1] = minTurn;
+	metrics->min[2] = minWait;
+	metrics->max[0] = maxResponse;
+	metrics->max[1] = maxTurn;
+	metrics->max[2] = maxWait;
+} // end function reduce()
+
+VECTOR_CLONES void reduce_block(SimTime* arrival, SimTime* start, SimTime* end, SimTime* wait, Metrics* metrics)
+{
+	reduce(METRIC_BLOCK, arrival, start, end, wait, metrics);
+} // end function reduce_block()
+
+void reduce_rows(int count, SimTime* arrival, SimTime* start, SimTime* end, SimTime* wait, Metrics* metrics)
+{
+	reduce(count, arrival, start, end, wait, metrics);
+} // end function reduce_rows()
+
+void print_spread()
+{
+	//Label times with their unit, when the workload declared one
+	char* unit = (outputUnit != NULL) ? outputUnit->name : "";
+	char* space = (outputUnit != NULL) ? " " : "";
+
+	printf("\tMIN/MAX Response Time: %.2f / %.2f%s%s\n"
+			"\tMIN/MAX Turnaround Time: %.2f / %.2f%s%s\n"
+			"\tMIN/MAX Wait Time: %.2f / %.2f%s%s\n",
+			summary.minResponseTime, summary.maxResponseTime, space, unit,
+			summary.minTurnTime, summary.maxTurnTime, space, unit,
+			summary.minWaitTime, summary.maxWaitTime, space, unit);
+
+	//Only the buckets between the shortest and longest turnaround
+	int low = 0;
+	int high = HISTOGRAM_BUCKETS - 1;
+	while (low < high && !summary.turnHistogram[low])
+	{
+		low++;
+	}
+	while (high > low && !summary.turnHistogram[high])
+	{
+		high--;
+	}
+
+	printf("\tTurnaround Histogram:\n");
+	int b;
+	for (b = low; b <= high; b++)
+	{
+		double bound = (b == 0) ? 1 : ((double)(1ULL << (b - 1)) * 2);
+		printf("\t\t< %.2f%s%s: %lld\n", to_output_unit(bound), space, unit, summary.turnHistogram[b]);
+	}
+} // end function print_spread()
+
+double to_output_unit(double time)
+{
+	if (outputUnit == inputUnit)
+	{
+		return time;
+	}
+
+	return time * ((double)inputUnit->nanoseconds / outputUnit->nanoseconds);
+} // end function to_output_unit()
+
 void print(char* algorithmType, double responseTime, double turnTime, double waitTime)
 {
-	//Print the description for the algorithm used
-	printf("\n%s:\n", algorithmType);
+	//Print the description for the algorithm used, unless the caller already has
+	if (algorithmType != NULL)
+	{
+		printf("\n%s:\n", algorithmType);
+	}
+
+	//Label times with their unit, when the workload declared one
+	char* unit = (outputUnit != NULL) ? outputUnit->name : "";
+	char* space = (outputUnit != NULL) ? " " : "";
 
 	//Print avg times
-	printf("\tAVG Response Time: %.2f\n"
-			"\tAVG Turnaround Time: %.2f\n"
-			"\tAVG Wait Time: %.2f\n",
-			responseTime, turnTime, waitTime);
+	printf("\tAVG Response Time: %.2f%s%s\n"
+			"\tAVG Turnaround Time: %.2f%s%s\n"
+			"\tAVG Wait Time: %.2f%s%s\n",
+			responseTime, space, unit, turnTime, space, unit, waitTime, space, unit);
 } // end function print()
 
+//***************************************************************************TABLE
+
+int table_reserve(ProcessTable* self, int capacity)
+{
+	//Grow every column, zeroing the new rows like the old static table. A column that can't
+	//grow keeps its rows, and the table keeps its old capacity
+	int grew = 1;
+#define RESERVE_COLUMN(type, name) \
+	{ \
+		type* column = realloc(self->name, sizeof(type) * capacity); \
+		if (column != NULL) \
+		{ \
+			memset(&column[self->capacity], 0, sizeof(type) * (capacity - self->capacity)); \
+			self->name = column; \
+		} \
+		grew = grew && (column != NULL); \
+	}
+	PROCESS_COLUMNS(RESERVE_COLUMN)
+#undef RESERVE_COLUMN
+
+	if (grew)
+	{
+		self->capacity = capacity;
+	}
+	return grew;
+} // end function table_reserve()
+
+void table_copy(ProcessTable* self, ProcessTable* other, int count)
+{
+#define COPY_COLUMN(type, name) \
+	memcpy(self->name, other->name, sizeof(type) * count);
+	PROCESS_COLUMNS(COPY_COLUMN)
+#undef COPY_COLUMN
+} // end function table_copy()
+
+void table_swap(ProcessTable* self, int a, int b)
+{
+#define SWAP_COLUMN(type, name) \
+	{ type temp = self->name[a]; self->name[a] = self->name[b]; self->name[b] = temp; }
+	PROCESS_COLUMNS(SWAP_COLUMN)
+#undef SWAP_COLUMN
+} // end function table_swap()
+
+void table_destructor(ProcessTable* self)
+{
+#define FREE_COLUMN(type, name) \
+	free(self->name); \
+	self->name = NULL;
+	PROCESS_COLUMNS(FREE_COLUMN)
+#undef FREE_COLUMN
+
+	self->capacity = 0;
+} // end destructor
+
+void table_copy_row(ProcessTable* self, int a, ProcessTable* other, int b)
+{
+#define COPY_ROW(type, name) \
+	self->name[a] = other->name[b];
+	PROCESS_COLUMNS(COPY_ROW)
+#undef COPY_ROW
+} // end function table_copy_row()
+
+void table_copy_rows(ProcessTable* self, int a, ProcessTable* other, int b, int count)
+{
+#define COPY_ROWS(type, name) \
+	memcpy(&self->name[a], &other->name[b], sizeof(type) * count);
+	PROCESS_COLUMNS(COPY_ROWS)
+#undef COPY_ROWS
+} // end function table_copy_rows()
+
+int table_rows_equal(ProcessTable* self, int a, ProcessTable* other, int b)
+{
+#define COMPARE_ROW(type, name) \
+	if (self->name[a] != other->name[b]) \
+	{ \
+		return 0; \
+	}
+	PROCESS_COLUMNS(COMPARE_ROW)
+#undef COMPARE_ROW
+
+	return 1;
+} // end function table_rows_equal()
+
+void sort_processes_by_arrival()
+{
+	//Sort pids by arrival, ties kept in their original order
+	int* order = malloc(sizeof(int) * numProcesses);
+	int i;
+	for (i = 0; i < numProcesses; i++)
+	{
+		order[i] = i;
+	}
+	qsort(order, numProcesses, sizeof(int), compare_arrival);
+
+	//Gather every column into the new order
+	ProcessTable sorted = { 0 };
+	table_reserve(&sorted, processes.capacity);
+	for (i = 0; i < numProcesses; i++)
+	{
+#define GATHER_COLUMN(type, name) \
+	sorted.name[i] = processes.name[order[i]];
+		PROCESS_COLUMNS(GATHER_COLUMN)
+#undef GATHER_COLUMN
+	}
+
+	table_destructor(&processes);
+	processes = sorted;
+	free(order);
+} // end function sort_processes_by_arrival()
+
+int compare_arrival(const void* a, const void* b)
+{
+	int left = *(const int*)a;
+	int right = *(const int*)b;
+
+	if (processes.arrivalTime[left] != processes.arrivalTime[right])
+	{
+		return (processes.arrivalTime[left] < processes.arrivalTime[right]) ? -1 : 1;
+	}
+	return left - right;
+} // end function compare_arrival()
+
 //***************************************************************************LIST
 void list_constructor(List* self)
 {
@@ -1096,7 +2128,7 @@ int duplicate(List* self, Node* newNode)
 	while (current != NULL)
 	{
 		//If a match isn't made
-		if (current->data->pid != newNode->data->pid)
+		if (current->pid != newNode->pid)
 		{
 			current = current->next;
 		}
@@ -1109,28 +2141,60 @@ int duplicate(List* self, Node* newNode)
 	return 0;
 } // end function duplicate()
 
+int remove_pid(List* self, int pid)
+{
+	Node* previous = NULL;
+	Node* current = self->first;
+
+	while (current != NULL && current->pid != pid)
+	{
+		previous = current;
+		current = current->next;
+	}
+
+	//Not on the list
+	if (current == NULL)
+	{
+		return 0;
+	}
+
+	//Unlink it, fixing up the ends
+	if (previous == NULL)
+	{
+		self->first = current->next;
+	}
+	else
+	{
+		set_next(previous, current->next);
+	}
+	if (self->last == current)
+	{
+		self->last = previous;
+	}
+	self->count--;
+
+	release_node(current);
+	return 1;
+} // end function remove_pid()
+
 //***************************************************************************NODE
 
 void node_constructor(Node* self)
 {
 	self->next = NULL;
-	self->data = NULL;
+	self->pid = -1;
 } // end constructor
 
-void node_param_constructor(Node* self, Process* _data)
+void node_param_constructor(Node* self, int _pid)
 {
-	self->data = _data;
+	self->pid = _pid;
 	self->next = NULL;
 } // end parameterized constructor
 
 void node_destructor(Node* self)
 {
-	//Check to ensure pointer has not already been deleted
-	if (self->data != NULL)
-	{
-		free(self->data);
-		self->data = NULL;
-	}
+	//Nodes only refer to processes by pid, so there's nothing to release
+	self->pid = -1;
 } // end destructor
 
 Node* get_next(Node* self)
@@ -1138,17 +2202,17 @@ Node* get_next(Node* self)
 	return self->next;
 } // end function get_next()
 
-Process* get_data(Node* self)
+int get_pid(Node* self)
 {
-	return self->data;
-} // end function get_data()
+	return self->pid;
+} // end function get_pid()
 
 void set_next(Node* self, Node* node)
 {
 	self->next = node;
 } // end function set_next()
 
-void set_data(Node* self, Process* process)
+void set_pid(Node* self, int pid)
 {
-	self->data = process;
-} // end function set_data()
\ No newline at end of file
+	self->pid = pid;
+} // end function set_pid()
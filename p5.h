@@ -25,44 +25,120 @@
 // ******************************************************************************************************************
 //
 
-#define MAX_PROCESSES 25
+#include <stdint.h> // needed for int64_t
+#include <stdio.h> // needed for FILE
+#include "p5policy.h"
+
+#define PER_THREAD __thread // engine state is private to each thread
+
+#define MAX_PROCESSES 25 // initial capacity of the process table, grown on demand
 #define QUANTUM 100
-#define MAX_TIME 100000
+#define STRIDE1 (1 << 20) // stride numerator, large enough to keep integer strides precise
+#define SHARE_SAMPLES 10 // default number of share gap samples per run
+#define CHECKPOINT_MAGIC "P5C3" // bump the digit when the header changes
+#define SERVER_BACKLOG 64 // connections waiting for a free worker
+#define PACKED_MAGIC "\x89P5Z" // the leading byte can't start a text workload
+#define PACKED_BLOCK 4096 // jobs per packed block
+#define PACKED_WEIGHTS 1 // block flag: jobs carry a weight
+#define PACKED_TASKS 2 // block flag: jobs carry a task
+#define PACKED_AFFINITY 4 // block flag: jobs carry an affinity mask
+#define PACKED_DEADLINES 8 // block flag: jobs carry a deadline
+#define VARINT_MAX 10 // bytes in the longest 64-bit varint
+#define MAX_CORES 64
+#define MAX_STEPS 8 // DVFS speeds per core
+#define WORK_SCALE 1024 // fixed point work per unit of burst
+#define METRIC_BLOCK 1024 // rows summed exactly in 64 bits before joining the running totals
+#define HISTOGRAM_BUCKETS 65 // turnaround times by power of two, bucket 0 for zero
 
-typedef struct process
-{
-	int pid;
-	int arrivalTime;
-	int burstTime;
-	int flag;
-	int startTime;
-	int latestStartTime;
-	int endTime;
-	int responseTime;
-	int waitTime;
-	int beginWaiting;
-	int turnTime;
-	int nextArriving;
-	int remainingQuantum;
-}Process;
-
-typedef struct processShell
+//Let the metric pass use AVX2 where the CPU has it, chosen when the program loads
+#if defined(__x86_64__) && defined(__GNUC__)
+#define VECTOR_CLONES __attribute__((target_clones("avx2", "default")))
+#else
+#define VECTOR_CLONES
+#endif
+#define WHATIF_SNAPSHOTS 256 // baseline snapshots kept for what-if replays
+#define WHATIF_RECORD 1 // what-if modes: snapshotting the baseline
+#define WHATIF_COMPARE 2 // replaying an edit, watching for the baseline
+#define CACHE_VERSION 4 // bump when a change to the simulator changes its results
+#define TELEMETRY_MAGIC "P5TS"
+#define TELEMETRY_COLUMNS 9
+#define TELEMETRY_WINDOWS 100 // default number of windows per run
+#define REPLICA_METRICS 4 // response, turnaround, wait, max turnaround
+#define BENCH_REPEATS 5 // fewest timed runs per bench case, the median counts
+#define BENCH_SAMPLES 2000 // most timed runs per bench case
+#define BENCH_BUDGET 0.25 // seconds of timed runs per bench case, past the fewest
+#define BENCH_SEED 12345
+#define BENCH_QUADRATIC_JOBS 1000 // largest bench size for the algorithms that rescan every job
+#define BENCH_TOLERANCE 0.20 // slowdown always allowed, widened when the timings are noisy
+#define BENCH_TOLERANCE_MAX 0.50 // widest the noise can make it, so every case can still fail
+#define BENCH_NOISY 0.10 // spread past which a case is timed again
+#define BENCH_RETRIES 3 // most extra timings of a noisy or failing case
+#define BENCH_RECORDS 3 // passes over the cases when recording, the slowest rate is stored
+#define BENCH_MEMORY_TOLERANCE 0.10
+#define BENCH_MEMORY_SLACK 1024 // KB of peak memory growth always allowed
+#define BENCH_PLUGIN "plugins/stride.so" // built by make bench, benched against the stride it reimplements
+#define BENCH_PLUGIN_POLICY "stride-plugin"
+#define BENCH_PLUGIN_BUILTIN "stride"
+#define USES_QUANTUM 1 // policy knobs that change the results, keyed into the cache
+#define USES_SEED 2
+#define USES_INTERVAL 4
+#define USES_QUEUE 8 // bounded by -Q, shedding with the admission policy
+#define USES_PREDICTION 16 // orders by bursts predicted with -p
+#define PREDICT_ALPHA 0.5 // default weight of the latest burst in a prediction
+#define USES_ADAPTIVE 32 // sizes its slices within the bounds from -b
+#define ADAPTIVE_SHRINK 4 // default shortest adaptive slice, as a fraction of the quantum
+#define ADAPTIVE_GROW 8 // default longest adaptive slice, as a multiple of the quantum
+#define SPLIT_MIN_JOBS 4096 // fewest jobs in a span of a split run
+#define SPLIT_SPANS 8 // spans per worker in a split run, to even out their lengths
+#define USES_PLUGIN 64 // loaded with -l: its code can change under the same name, so it's never cached
+#define MAX_PLUGINS 8
+#define POLICY_SLOTS 24 // the built in policies, room for the plugins and the terminator
+
+//Simulated time, in the unit the workload declares (nanoseconds for captured traces)
+typedef int64_t SimTime;
+
+typedef struct timeUnit
 {
-	struct process* core;
-	struct processShell* next;
-}ProcessShell;
+	char* name;
+	int64_t nanoseconds;
+}TimeUnit;
+
+//Process table columns, hot fields first: the event loops scan these on every
+//step, the rest are touched once per dispatch or when the metrics are summed
+#define PROCESS_COLUMNS(COLUMN) \
+	COLUMN(SimTime, arrivalTime) \
+	COLUMN(SimTime, burstTime) \
+	COLUMN(int, flag) \
+	COLUMN(int, waiting) \
+	COLUMN(SimTime, beginWaiting) \
+	COLUMN(int, started) \
+	COLUMN(SimTime, startTime) \
+	COLUMN(SimTime, latestStartTime) /* start of the current run segment */ \
+	COLUMN(SimTime, endTime) \
+	COLUMN(SimTime, waitTime) \
+	COLUMN(SimTime, nextArriving) \
+	COLUMN(SimTime, remainingQuantum) \
+	COLUMN(int, weight) \
+	COLUMN(int, task) /* pid of the traced task a job came from, 0 if untraced */ \
+	COLUMN(uint64_t, affinity) /* bit per core the job may run on under the machine model, 0 for any */ \
+	COLUMN(int, group) /* fair share group, 0 for the root */ \
+	COLUMN(SimTime, deadline) /* latency budget from arrival, 0 for none */ \
+	COLUMN(int, shed) /* turned away by admission control, never ran */ \
+	COLUMN(SimTime, predicted) /* estimated burst left, for psjf and psrtf */
 
-typedef struct processq
+//Structure of arrays, indexed by pid
+typedef struct processTable
 {
-	int size;
-	struct processShell* front;
-	struct processShell* back;
-}ProcessQ;
+#define DECLARE_COLUMN(type, name) type* name;
+	PROCESS_COLUMNS(DECLARE_COLUMN)
+#undef DECLARE_COLUMN
+	int capacity;
+}ProcessTable;
 
 typedef struct node
 {
 	struct node* next;
-	struct process* data;
+	int pid;
 }Node;
 
 typedef struct list
@@ -72,16 +148,225 @@ typedef struct list
 	int count;
 }List;
 
+typedef struct policy
+{
+	char* name;
+	void (*run)();
+	void (*resume)(); // continues a run restored from a checkpoint, NULL if unsupported
+	int uses; // USES_ flags for the knobs it reads
+}Policy;
+
+//Per task state while importing a trace
+typedef struct task
+{
+	int pid; // 0 marks a free slot
+	int runnable; // a job is open: woken and not yet blocked
+	SimTime arrival;
+	SimTime burst;
+	SimTime firstRun;
+	SimTime switchedIn; // -1 when off cpu
+}Task;
+
+//Averages from a finished run, with the extremes and the spread of turnaround times
+typedef struct summary
+{
+	double responseTime;
+	double turnTime;
+	double waitTime;
+	double minResponseTime;
+	double maxResponseTime;
+	double minTurnTime;
+	double maxTurnTime;
+	double minWaitTime;
+	double maxWaitTime;
+	long long turnHistogram[HISTOGRAM_BUCKETS]; // bucket b holds times in [2^(b-1), 2^b), in workload units
+	int shedJobs; // turned away by admission control, left out of everything above
+	double p99TurnTime; // of the admitted jobs, only worked out when the run queue is bounded
+}Summary;
+
+//A node of the fair share tree
+typedef struct group
+{
+	char* path;
+	int parent; // -1 for the root
+	int weight; // share against sibling groups
+	SimTime quota; // cpu time allowed per period, 0 for no cap
+	SimTime period;
+	int* heap; // runnable children, by pass: pids, or -(group + 1) for child groups
+	int heapCount;
+	int heapCapacity;
+	long long pass;
+	long long lastPass; // pass of the entry last picked from the heap
+	SimTime usage; // cpu time used this period
+	SimTime periodEnd;
+	int queued; // in its parent's heap
+	int onPath; // on the path of the slice being run
+	int throttled; // out of quota until periodEnd
+	SimTime service; // cpu time its own jobs got
+}Group;
+
+//A core of the machine model
+typedef struct core
+{
+	double steps[MAX_STEPS]; // DVFS speeds, fastest first; one step for a fixed speed
+	int stepCount;
+	double speed; // speed until the next event
+	int llc; // last level cache domain
+	int node; // NUMA node
+	int job; // pid running here, -1 when idle
+	SimTime busyTime;
+	int jobsRun; // dispatches, a preempted job counts again when it comes back
+}Core;
+
+//One bench case: its speed, peak memory and averages, as stored in the baseline
+typedef struct benchResult
+{
+	char name[64]; // shape-size-algorithm
+	double jobsPerSecond; // at the median of the repetitions
+	double spread; // median absolute deviation of the timings, over the median
+	long peakKb;
+	double responseTime;
+	double turnTime;
+	double waitTime;
+}BenchResult;
+
+//A small workload whose averages were worked out by hand, run before the timed cases
+typedef struct benchCheck
+{
+	char* name;
+	char* policy;
+	SimTime quantum;
+	SimTime tick; // timer tick period for -z, 0 = event driven
+	SimTime resume; // checkpoint at the first event from here and resume under the defaults, 0 = run through
+	char* jobs; // arrival:burst pairs
+	double responseTime;
+	double turnTime;
+	double waitTime;
+}BenchCheck;
+
+//Partial results over a block of rows
+typedef struct metrics
+{
+	SimTime sum[3]; // response, turnaround, wait
+	SimTime min[3];
+	SimTime max[3];
+}Metrics;
+
+//Snapshot header, followed by the run queue pids and the first horizon rows of every column
+typedef struct checkpoint
+{
+	char magic[4];
+	char policy[16];
+	unsigned long long fingerprint;
+	int numProcesses;
+	int horizon;
+	SimTime clock;
+	int running;
+	int processesRemaining;
+	int waitingCount;
+	int contextSwitches; // rr's count so far, carried on by a resumed run
+
+	//The run's settings, which a resumed run takes over
+	SimTime quantum;
+	unsigned long long randomState;
+	double predictAlpha;
+	SimTime predictInitial;
+	SimTime adaptiveMin;
+	SimTime adaptiveMax;
+	SimTime adaptiveLatency;
+	int queueCapacity;
+	char admission[16];
+	SimTime tickPeriod;
+	SimTime tickCost;
+	int ticklessIdle;
+}Checkpoint;
+
+//Baseline state kept in memory for what-if replays: the globals, the run queue, and the
+//rows still in play. Finished rows are frozen, so they come back from the baseline's final table
+typedef struct snapshot
+{
+	Checkpoint header;
+	int* queue; // run queue pids, front to back
+	int* live; // pids of the rows below, in order
+	int liveCount;
+	ProcessTable rows;
+}Snapshot;
+
+//Globals shared with the front ends
+extern PER_THREAD ProcessTable processes;
+extern PER_THREAD List waitingList;
+extern PER_THREAD int running;
+extern PER_THREAD SimTime simClock;
+extern PER_THREAD int processesRemaining;
+extern PER_THREAD int* pendingSJF;
+extern PER_THREAD int numProcesses;
+extern PER_THREAD SimTime quantum;
+extern PER_THREAD int quiet;
+extern PER_THREAD Summary summary;
+extern PER_THREAD int showSpread;
+extern PER_THREAD unsigned long long randomState;
+extern PER_THREAD SimTime shareInterval;
+extern PER_THREAD TimeUnit* inputUnit;
+extern PER_THREAD TimeUnit* outputUnit;
+extern PER_THREAD unsigned long long workloadFingerprint;
+extern PER_THREAD char* checkpointPath;
+extern PER_THREAD SimTime checkpointInterval;
+extern PER_THREAD SimTime stopTime;
+extern PER_THREAD SimTime nextCheckpoint;
+extern TimeUnit timeUnits[];
+extern PER_THREAD Summary observed;
+extern PER_THREAD int observedJobs;
+extern PER_THREAD int whatIfMode;
+extern PER_THREAD int coreCount;
+extern PER_THREAD char* placement;
+extern PER_THREAD int topologyGiven;
+extern PER_THREAD int groupCount;
+extern PER_THREAD int* strideHeap;
+extern PER_THREAD int heapCount;
+extern PER_THREAD long long* pass;
+extern PER_THREAD SimTime* remainingBurst;
+extern PER_THREAD int queueCapacity;
+extern PER_THREAD char* admission;
+extern PER_THREAD char* telemetryPath;
+extern PER_THREAD SimTime telemetryWindow;
+extern PER_THREAD int idleCount;
+extern PER_THREAD int predictBursts;
+extern PER_THREAD double predictAlpha;
+extern PER_THREAD SimTime predictInitial;
+extern PER_THREAD int adaptiveQuantum;
+extern PER_THREAD SimTime adaptiveMin;
+extern PER_THREAD SimTime adaptiveMax;
+extern PER_THREAD SimTime adaptiveLatency;
+extern PER_THREAD int contextSwitches;
+extern PER_THREAD int showGap;
+extern PER_THREAD int splitPending;
+extern PER_THREAD SimTime tickPeriod;
+extern PER_THREAD SimTime tickCost;
+extern PER_THREAD int tickHz;
+extern PER_THREAD int ticklessIdle;
+extern Policy policies[];
+extern const P5Policy lotteryPolicy;
+extern const P5Policy stridePolicy;
+extern const P5Policy groupPolicy;
+extern char pluginError[];
+
 //MISC
 void read_raw_data();
+void finish_workload();
+void read_attributes(int pid, char* attributes);
+int add_process(SimTime arrivalTime, SimTime burstTime);
+TimeUnit* find_unit(char* name);
+Policy* find_policy(char* name);
 void init_all();
 void calc_times_and_print(char* algorithmType);
+void reduce_block(SimTime* arrival, SimTime* start, SimTime* end, SimTime* wait, Metrics* metrics);
+void reduce_rows(int count, SimTime* arrival, SimTime* start, SimTime* end, SimTime* wait, Metrics* metrics);
+void print_spread();
+double to_output_unit(double time);
 void print(char* algorithmType, double responseTime, double turnTime, double waitTime);
 
 //FIRST COME, FIRST SERVE
 void fcfs();
-void next_process();
-void update();
 
 //SHORTEST JOB FIRST
 void sjf();
@@ -92,6 +377,7 @@ void sort_by_arrival_sjf();
 
 //SHORTEST REMAINING TIME FIRST
 void srtf();
+void run_srtf();
 int next_event();
 void add_arrivals();
 void fork_srtf();
@@ -99,22 +385,257 @@ void running_to_waiting(); // shared with rr
 void waiting_to_running();
 void runner_complete(); // shared with rr
 int process_interrupt();
-int query_next_arrival(); // shared with rr
+int query_next_arrival(SimTime* arrival); // shared with rr
 void force_start(); // shared with rr
 void update_srtf();
-void send_to_waiting(Process* process); // shared with all
+void send_to_waiting(int pid); // shared with all
+Node* acquire_node(int pid);
+void release_node(Node* node);
 void sort_list_burst();
+SimTime* burst_keys();
 
 //ROUND ROBIN
 void rr();
+void run_rr();
 int next_event_rr();
 void add_arrivals_rr();
 void fork_rr();
 int process_interrupt_rr();
-int get_remaining_burst();
-int get_relative_start();
+SimTime get_remaining_burst(); // shared with srtf
+SimTime get_relative_start(); // shared with srtf
 void waiting_to_running_rr();
 
+//PROPORTIONAL SHARE
+void lottery();
+void stride();
+void run_share(char* algorithmType, const P5Policy* policy);
+void admit_arrivals_share(const P5Policy* policy, void* state);
+void share_join(int pid, const P5Policy* policy, void* state);
+void share_leave(int pid);
+void sample_share_gap();
+void reserve_share(int count);
+unsigned long long next_random();
+
+//LOTTERY
+void join_lottery(void* state, int pid, const P5PolicyJob* job);
+int pick_lottery(void* state, int64_t now, int64_t* slice);
+void requeue_lottery(void* state, int pid, int64_t ran);
+void leave_lottery(void* state, int pid, int64_t ran);
+void fenwick_add(int index, long long delta);
+int fenwick_find(long long ticket);
+
+//STRIDE
+void join_stride(void* state, int pid, const P5PolicyJob* job);
+int pick_stride(void* state, int64_t now, int64_t* slice);
+void requeue_stride(void* state, int pid, int64_t ran);
+void leave_stride(void* state, int pid, int64_t ran);
+void heap_push(int pid);
+int heap_pop();
+int heap_less(int a, int b);
+
+//TABLE
+int table_reserve(ProcessTable* self, int capacity);
+void table_copy(ProcessTable* self, ProcessTable* other, int count);
+void table_swap(ProcessTable* self, int a, int b);
+void table_destructor(ProcessTable* self);
+void table_copy_row(ProcessTable* self, int a, ProcessTable* other, int b);
+void table_copy_rows(ProcessTable* self, int a, ProcessTable* other, int b, int count);
+int table_rows_equal(ProcessTable* self, int a, ProcessTable* other, int b);
+void sort_processes_by_arrival();
+int compare_arrival(const void* a, const void* b);
+
+//CHECKPOINT
+int checkpoint_due();
+int write_checkpoint(char* policyName);
+Policy* read_checkpoint(char* path);
+unsigned long long fingerprint_workload();
+
+//TRACE
+void read_trace(int cpu);
+void trace_switch(char* line, char* event, char* fields);
+void trace_wakeup(char* line, char* event, char* fields);
+int parse_trace_header(char* line, char* event, SimTime* time, int* cpu);
+int trace_compact_pid(char* start, char* end);
+Task* find_task(int pid);
+void remove_task(Task* task);
+void grow_tasks();
+void open_job(Task* task, SimTime time);
+void emit_job(Task* task, SimTime end);
+
+//PACKED
+void write_packed(FILE* out);
+void read_packed(FILE* in);
+void decode_block(unsigned char* cursor, unsigned char* end, int count, int flags, SimTime arrival);
+int put_varint(unsigned char* buffer, uint64_t value);
+uint64_t get_varint(unsigned char** cursor, unsigned char* end);
+uint64_t read_varint(FILE* in);
+
+//WHAT-IF
+int parse_edits(char* text);
+void what_if(Policy* policy, ProcessTable* original, char** queries, int queryCount);
+void replay_edits(Policy* policy, ProcessTable* original);
+int what_if_checkpoint();
+void take_snapshot(Snapshot* snapshot);
+void restore_snapshot(Snapshot* snapshot);
+int matches_snapshot(Snapshot* snapshot);
+int find_live_rows(int horizon);
+int edits_finished();
+void clear_snapshots();
+
+//GROUP FAIR SHARE
+int read_group(char* line);
+int find_group(char* path, int create);
+int add_group(char* path, int length, int parent);
+void index_group(int g);
+unsigned hash_path(char* path, size_t length);
+unsigned long long fingerprint_groups(unsigned long long hash);
+void group_fair();
+void join_group(void* state, int pid, const P5PolicyJob* job);
+int pick_group(void* state, int64_t now, int64_t* slice);
+void requeue_group(void* state, int pid, int64_t ran);
+void leave_group(void* state, int pid, int64_t ran);
+void charge_groups(int g, SimTime ran);
+void roll_period(int g);
+void release_groups();
+void group_activate(int g);
+long long entry_pass(int entry);
+int entry_less(int a, int b);
+void group_push(int g, int entry);
+int group_pop(int g);
+void print_groups();
+int compare_times(const void* a, const void* b);
+
+//MACHINE
+int parse_machine(char* text);
+int parse_topology(char* text);
+int parse_migration_costs(char* text);
+int parse_cpu_list(char* text, uint64_t* mask);
+int machine_supports(char* name);
+int check_affinity();
+int core_distance(Core* a, Core* b);
+void run_machine(Policy* policy);
+void preempt_machine();
+void dispatch_machine();
+int idle_cores();
+int allowed(int pid, int core);
+Core* place_job(int pid);
+void dispatch_to(Core* core, int pid);
+void set_core_speeds();
+SimTime core_finish_time(Core* core);
+char* machine_label(Policy* policy);
+void print_cores();
+
+//ADMISSION
+char* find_admission(const char* name);
+void admit_to_waiting(int pid);
+int choose_victim(int pid);
+int shed_before(int a, int b);
+SimTime job_slack(int pid);
+void shed_process(int pid);
+int gather_admitted(SimTime* rows);
+SimTime admitted_p99(SimTime* arrival, SimTime* end, int count);
+void print_admission();
+
+//PREDICTION
+int parse_prediction(char* text);
+void psjf();
+void psrtf();
+void resume_psrtf();
+void predict_bursts();
+char* prediction_label(char* label, char* buffer, size_t size);
+void print_prediction();
+int compare_task(const void* a, const void* b);
+
+//ADAPTIVE QUANTUM
+int parse_adaptive(char* text);
+void adaptive_bounds(SimTime* low, SimTime* high, SimTime* latency);
+void arr();
+void resume_arr();
+SimTime adaptive_quantum(int pid);
+void start_slice(int pid);
+void renew_slice(int pid);
+char* adaptive_label(char* buffer, size_t size);
+void print_adaptive();
+
+//BOUNDS
+void compute_bounds();
+void srpt_push(SimTime remaining, int pid);
+void srpt_pop();
+int srpt_less(SimTime remaining, int pid, SimTime otherRemaining, int otherPid);
+void print_gap();
+
+//SPLIT
+int splits_at_idle(char* name);
+int find_spans(int workers);
+void run_split(Policy* policy, int workers);
+void* split_worker(void* unused);
+void load_span(int span);
+void gather_spans();
+
+//TICK
+int parse_tick(char* text);
+int resolve_tick();
+int ticks_supported(char* name);
+void run_ticked(Policy* policy);
+void enqueue_ticked(int pid, int preemptive);
+int dequeue_ticked(int preemptive);
+SimTime preemption_tick(int preemptive, SimTime sliceUsed, int arrivalsLeft);
+SimTime tick_finish(SimTime from, SimTime work);
+SimTime tick_work(SimTime from, SimTime to);
+void pass_ticks(SimTime to, int busy);
+void idle_ticked(SimTime to);
+SimTime tick_floor(SimTime time);
+void print_ticks();
+
+//PLUGIN
+int load_plugin(char* path);
+void run_plugin(int slot);
+
+//TELEMETRY
+void telemetry_idle(SimTime from, SimTime to);
+void write_telemetry(char* policyName);
+void print_telemetry(FILE* in);
+int compare_end(const void* a, const void* b);
+
+//REPLICATION
+int parse_generator(char* text);
+int replicate(char* algorithms, int replicas, int workers);
+void* replica_worker(void* unused);
+unsigned long long replica_stream(int replica);
+double replica_uniform(unsigned long long* state);
+void generate_replica(unsigned long long* state);
+void resample_replica(unsigned long long* state);
+void print_replicas();
+double replica_metric(int replica, int policy, int metric);
+void confidence_interval(double* samples, int count, double* mean, double* half);
+double t_critical(int df);
+
+//BENCH
+int is_quadratic(char* name);
+int run_check(BenchCheck* check);
+int measure_case(char* shape, int jobs, Policy* policy, BenchResult* result);
+int run_case(char* shape, int jobs, Policy* policy, BenchResult* result);
+void time_case(char* shape, int jobs, Policy* policy, BenchResult* result);
+void generate_case(char* shape, int jobs);
+double bench_uniform();
+int compare_case(BenchResult* result, BenchResult* base, char* verdict, size_t size);
+int same_metric(double value, double expected);
+int read_baseline(char* path, BenchResult** results);
+BenchResult* find_baseline(BenchResult* results, int count, char* name);
+int compare_seconds(const void* a, const void* b);
+
+//CACHE
+void run_cached(Policy* policy, char* directory);
+unsigned long long cache_key(Policy* policy);
+int replay_cached(char* path);
+void store_cached(char* path, char* report, size_t length);
+
+//SERVER
+struct p5Job;
+int serve(char* path, int workers);
+void* serve_worker(void* unused);
+void serve_connection(int fd, struct p5Job** jobs, int* capacity);
+
 //LIST
 void list_constructor(List* self);
 void list_param_constructor(List* self, Node* _first, Node* _last, int _count);
@@ -124,12 +645,13 @@ Node* pop_front(List* self);
 void push_back(List* self, Node* newNode);
 Node* pop_back(List* self);
 int duplicate(List* self, Node* newNode);
+int remove_pid(List* self, int pid);
 
 //NODE
 void node_constructor(Node* self);
-void node_param_constructor(Node* self, Process* _data);
+void node_param_constructor(Node* self, int _pid);
 void node_destructor(Node* self);
 Node* get_next(Node* self);
-Process* get_data(Node* self);
+int get_pid(Node* self);
 void set_next(Node* self, Node* node);
-void set_data(Node* self, Process* process);
\ No newline at end of file
+void set_pid(Node* self, int pid);
\ No newline at end of file
@@ -0,0 +1,207 @@
+// ******************************************************************************************************************
+//  CPU Scheduler
+//  Copyright(C) 2018  James LoForti
+//  Contact Info: jamesloforti@gmail.com
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.If not, see<https://www.gnu.org/licenses/>.
+//									     ____.           .____             _____  _______   
+//									    |    |           |    |    ____   /  |  | \   _  \  
+//									    |    |   ______  |    |   /  _ \ /   |  |_/  /_\  \ 
+//									/\__|    |  /_____/  |    |__(  <_> )    ^   /\  \_/   \
+//									\________|           |_______ \____/\____   |  \_____  /
+//									                             \/          |__|        \/ 
+//
+// ******************************************************************************************************************
+//
+
+//Library entry points, wrapping the engine in p5.c
+
+#include <stdlib.h> 
+#include <string.h> // needed for memset()
+#include "p5.h"
+#include "p5lib.h"
+
+int p5_simulate(const P5Job* jobs, int count, const P5Config* config, P5Result* result)
+{
+	memset(result, 0, sizeof(P5Result));
+
+	//Validate the request before touching the engine
+	Policy* policy = find_policy((char*)config->policy);
+	if (policy == NULL)
+	{
+		return P5_EPOLICY;
+	}
+	if (jobs == NULL || count <= 0)
+	{
+		return P5_EWORKLOAD;
+	}
+
+	int i;
+	for (i = 0; i < count; i++)
+	{
+		if (jobs[i].burstTime <= 0 || jobs[i].weight < 0 || jobs[i].task < 0 || jobs[i].deadline < 0
+			|| (i && jobs[i].arrivalTime < jobs[i - 1].arrivalTime))
+		{
+			return P5_EWORKLOAD;
+		}
+	} // end for
+
+	//The same limits the command line puts on each setting, and only settings the policy takes
+	const char* shedding = (config->admission != NULL) ? config->admission : "reject";
+	int adaptiveGiven = (config->adaptiveMin || config->adaptiveMax || config->adaptiveLatency);
+	if ((config->quantum && !(policy->uses & USES_QUANTUM)) || (config->seed && !(policy->uses & USES_SEED))
+		|| ((config->predictAlpha || config->predictInitial) && !(policy->uses & USES_PREDICTION))
+		|| (adaptiveGiven && !(policy->uses & USES_ADAPTIVE)) || (config->admission != NULL && !(policy->uses & USES_QUEUE))
+		|| (!config->tickPeriod && (config->tickCost || config->ticklessIdle)))
+	{
+		return P5_ECONFIG;
+	}
+	if (config->predictAlpha < 0 || config->predictAlpha > 1 || config->predictInitial < 0
+		|| (adaptiveGiven && (config->adaptiveMin < 1 || config->adaptiveMax < config->adaptiveMin || config->adaptiveLatency < 0))
+		|| config->queueCapacity < 0 || (config->queueCapacity > 0 && !(policy->uses & USES_QUEUE))
+		|| find_admission(shedding) == NULL
+		|| config->tickPeriod < 0 || (config->tickPeriod > 0 && (!ticks_supported(policy->name) || config->queueCapacity > 0
+		|| config->tickCost < 0 || config->tickCost >= config->tickPeriod)))
+	{
+		return P5_ECONFIG;
+	}
+
+	result->jobs = malloc(sizeof(P5JobResult) * count);
+	if (result->jobs == NULL)
+	{
+		return P5_ENOMEM;
+	}
+
+	//Apply the policy config, remembering the caller's settings. Predictions are made as
+	//the workload loads, so this comes first
+	SimTime savedQuantum = quantum;
+	unsigned long long savedState = randomState;
+	SimTime savedInterval = checkpointInterval;
+	int savedQuiet = quiet;
+	double savedAlpha = predictAlpha;
+	SimTime savedInitial = predictInitial;
+	SimTime savedSlices[3] = { adaptiveMin, adaptiveMax, adaptiveLatency };
+	int savedCapacity = queueCapacity;
+	char* savedAdmission = admission;
+	SimTime savedTick[2] = { tickPeriod, tickCost };
+	int savedTickless = ticklessIdle;
+	quantum = (config->quantum > 0) ? config->quantum : QUANTUM;
+	randomState = config->seed ? config->seed : 1;
+	predictAlpha = (config->predictAlpha > 0) ? config->predictAlpha : PREDICT_ALPHA;
+	predictInitial = config->predictInitial;
+	adaptiveMin = config->adaptiveMin;
+	adaptiveMax = config->adaptiveMax;
+	adaptiveLatency = config->adaptiveLatency;
+	queueCapacity = config->queueCapacity;
+	admission = (char*)shedding;
+	tickPeriod = config->tickPeriod;
+	tickCost = config->tickCost;
+	ticklessIdle = config->ticklessIdle;
+	checkpointInterval = 0;
+	quiet = 1;
+	inputUnit = NULL;
+	outputUnit = NULL;
+
+	//Load the workload into the process table, reusing its allocation
+	numProcesses = 0;
+	for (i = 0; i < count; i++)
+	{
+		int pid = add_process(jobs[i].arrivalTime, jobs[i].burstTime);
+		processes.weight[pid] = jobs[i].weight ? jobs[i].weight : 1;
+		processes.task[pid] = jobs[i].task;
+		processes.deadline[pid] = jobs[i].deadline;
+	}
+	finish_workload();
+
+	//Run it
+	init_all();
+	if (tickPeriod > 0)
+	{
+		run_ticked(policy);
+	}
+	else
+	{
+		policy->run();
+	}
+
+	quantum = savedQuantum;
+	randomState = savedState;
+	checkpointInterval = savedInterval;
+	quiet = savedQuiet;
+	predictAlpha = savedAlpha;
+	predictInitial = savedInitial;
+	adaptiveMin = savedSlices[0];
+	adaptiveMax = savedSlices[1];
+	adaptiveLatency = savedSlices[2];
+	queueCapacity = savedCapacity;
+	admission = savedAdmission;
+	tickPeriod = savedTick[0];
+	tickCost = savedTick[1];
+	ticklessIdle = savedTickless;
+
+	//Collect per process and average times
+	result->count = count;
+	result->responseTime = summary.responseTime;
+	result->turnTime = summary.turnTime;
+	result->waitTime = summary.waitTime;
+
+	SimTime lastEnd = 0;
+	for (i = 0; i < count; i++)
+	{
+		P5JobResult* job = &result->jobs[i];
+		memset(job, 0, sizeof(P5JobResult));
+		if (processes.shed[i])
+		{
+			job->shed = 1;
+			continue;
+		}
+
+		job->startTime = processes.startTime[i];
+		job->endTime = processes.endTime[i];
+		job->responseTime = (processes.startTime[i] - processes.arrivalTime[i]);
+		job->turnTime = (processes.endTime[i] - processes.arrivalTime[i]);
+		job->waitTime = processes.waitTime[i];
+
+		lastEnd = (job->endTime > lastEnd) ? job->endTime : lastEnd;
+	} // end for
+	result->makespan = (lastEnd - processes.arrivalTime[0]);
+
+	return P5_OK;
+} // end function p5_simulate()
+
+void p5_result_free(P5Result* result)
+{
+	free(result->jobs);
+	result->jobs = NULL;
+	result->count = 0;
+} // end function p5_result_free()
+
+const char* p5_strerror(int code)
+{
+	switch (code)
+	{
+	case P5_OK:
+		return "success";
+	case P5_EPOLICY:
+		return "unknown policy";
+	case P5_EWORKLOAD:
+		return "invalid workload";
+	case P5_ENOMEM:
+		return "out of memory";
+	case P5_ECONFIG:
+		return "invalid setting";
+	default:
+		return "unknown error";
+	}
+} // end function p5_strerror()
@@ -0,0 +1,109 @@
+// ******************************************************************************************************************
+//  CPU Scheduler
+//  Copyright(C) 2018  James LoForti
+//  Contact Info: jamesloforti@gmail.com
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.If not, see<https://www.gnu.org/licenses/>.
+//									     ____.           .____             _____  _______   
+//									    |    |           |    |    ____   /  |  | \   _  \  
+//									    |    |   ______  |    |   /  _ \ /   |  |_/  /_\  \ 
+//									/\__|    |  /_____/  |    |__(  <_> )    ^   /\  \_/   \
+//									\________|           |_______ \____/\____   |  \_____  /
+//									                             \/          |__|        \/ 
+//
+// ******************************************************************************************************************
+//
+
+//Public interface for embedding the scheduler in another program: hand it a workload
+//and a policy, get back per process and average times, without printing anything.
+//Engine state is private to each thread, so threads can simulate side by side.
+
+#ifndef P5LIB_H
+#define P5LIB_H
+
+#include <stdint.h> // needed for int64_t
+
+#if defined(__GNUC__)
+#define P5_API __attribute__((visibility("default")))
+#else
+#define P5_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//Return codes
+#define P5_OK 0
+#define P5_EPOLICY -1 // unknown policy name
+#define P5_EWORKLOAD -2 // empty workload, unsorted arrivals, or a non-positive burst or weight
+#define P5_ENOMEM -3
+#define P5_ECONFIG -4 // a setting out of range, one the policy doesn't take, or a tick cost without a tick
+
+typedef struct p5Job
+{
+	int64_t arrivalTime; // jobs must be sorted by arrival time
+	int64_t burstTime;
+	int weight; // proportional share weight, 0 = 1
+	int task; // task the job came from, whose earlier bursts psjf and psrtf predict from; 0 = untraced
+	int64_t deadline; // latency budget from arrival for deadline admission, 0 = none
+}P5Job;
+
+typedef struct p5Config
+{
+	const char* policy; // fcfs, sjf, srtf, rr, lottery, stride, group, psjf, psrtf or arr; group
+				// runs every job in the root group, since groups are only read from workload files
+	int64_t quantum; // rr, arr, psjf, psrtf and the share policies: 0 = default of 100
+	uint64_t seed; // lottery and plugins: 0 = default of 1
+	double predictAlpha; // psjf and psrtf: weight of the latest burst, in (0, 1]; 0 = default of 0.5
+	int64_t predictInitial; // psjf and psrtf: guess for a task's first burst, 0 = one quantum
+	int64_t adaptiveMin; // arr: shortest slice, 0 = a quarter quantum; set all three or none
+	int64_t adaptiveMax; // arr: longest slice, 0 = 8 quanta
+	int64_t adaptiveLatency; // arr: target for a turn of the run queue, 0 = the longest slice
+	int queueCapacity; // srtf, psrtf, rr and arr: jobs allowed to wait before one is shed, 0 = unbounded
+	const char* admission; // srtf, psrtf, rr and arr: who is shed, reject, oldest, priority or deadline; NULL = reject
+	int64_t tickPeriod; // srtf and rr: preempt only on a timer tick of this period, 0 = event driven
+	int64_t tickCost; // time each tick spends in its handler, below the period
+	int ticklessIdle; // stop the tick while the cpu is idle
+}P5Config;
+
+typedef struct p5JobResult
+{
+	int64_t startTime;
+	int64_t endTime;
+	int64_t responseTime;
+	int64_t turnTime;
+	int64_t waitTime;
+	int shed; // turned away by admission control: it never ran, and its times are 0
+}P5JobResult;
+
+typedef struct p5Result
+{
+	int count;
+	double responseTime; // averages over every job
+	double turnTime;
+	double waitTime;
+	int64_t makespan; // last end time minus first arrival
+	P5JobResult* jobs; // one per job, in input order
+}P5Result;
+
+P5_API int p5_simulate(const P5Job* jobs, int count, const P5Config* config, P5Result* result);
+P5_API void p5_result_free(P5Result* result);
+P5_API const char* p5_strerror(int code);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,107 @@
+// ******************************************************************************************************************
+//  CPU Scheduler
+//  Copyright(C) 2018  James LoForti
+//  Contact Info: jamesloforti@gmail.com
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.If not, see<https://www.gnu.org/licenses/>.
+//									     ____.           .____             _____  _______   
+//									    |    |           |    |    ____   /  |  | \   _  \  
+//									    |    |   ______  |    |   /  _ \ /   |  |_/  /_\  \ 
+//									/\__|    |  /_____/  |    |__(  <_> )    ^   /\  \_/   \
+//									\________|           |_______ \____/\____   |  \_____  /
+//									                             \/          |__|        \/ 
+//
+// ******************************************************************************************************************
+//
+
+//Policy plugin interface: a scheduling policy as five callbacks, built into a shared object
+//and loaded at run time with -l. The engine owns the clock, the process table and the
+//metrics; the policy only keeps its run queue. The built-in lottery, stride and group
+//policies are written against this same interface. fcfs, sjf, srtf, rr and their variants
+//keep their own loops: the engine can't see a plugin's queue, so srtf and rr couldn't be
+//checkpointed with -c, replayed by -E or bounded by -Q; picks only come at slice ends, so
+//srtf couldn't preempt for a shorter arrival; and fcfs and sjf would be cut into quanta
+//and report share gaps they don't have.
+//
+//Per run, the engine calls init once, then for as long as jobs remain:
+//	on_arrival	for each job as it arrives, in arrival order
+//	pick_next	for the job to run next; the slice starts out as the quantum and may be lowered.
+//			With nothing it's willing to run, return -1 and set the slice to how long to
+//			idle, which is cut short by the next arrival
+//	on_preempt	when the picked job used up its slice and goes back in line
+//	on_complete	when the picked job finished within its slice
+//then fini. pick_next must return a job that has arrived and not completed. Jobs are
+//numbered by arrival from 0. Several runs may be in flight on different threads, each with
+//its own state from init, so a plugin must keep everything in that state.
+//
+//The plugin exports one function, p5_policy, returning its description. Bump P5_POLICY_ABI
+//on any change to the structures below; a plugin built against another version is refused.
+
+#ifndef P5POLICY_H
+#define P5POLICY_H
+
+#include <stdint.h> // needed for int64_t
+
+#if defined(__GNUC__)
+#define P5_POLICY_EXPORT __attribute__((visibility("default")))
+#else
+#define P5_POLICY_EXPORT
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define P5_POLICY_ABI 1
+#define P5_POLICY_SYMBOL "p5_policy" // name of the function a plugin exports
+
+//What a run is about to simulate
+typedef struct p5PolicyEnv
+{
+	int abi; // the engine's P5_POLICY_ABI
+	int jobs; // job numbers run from 0 to jobs - 1
+	int64_t quantum;
+	uint64_t seed; // for policies that draw at random
+}P5PolicyEnv;
+
+//A job as it arrives; the pointer is only good during the call
+typedef struct p5PolicyJob
+{
+	int64_t arrivalTime;
+	int64_t burstTime; // the whole burst: a policy may peek, a realistic one won't
+	int weight; // proportional share weight, at least 1
+	int task; // traced task the job came from, 0 if untraced
+	int group; // fair share group, 0 for the root
+	int64_t deadline; // latency budget from arrival, 0 for none
+}P5PolicyJob;
+
+typedef struct p5Policy
+{
+	int abi; // P5_POLICY_ABI the policy was built against
+	const char* name; // what -a calls it
+	void* (*init)(const P5PolicyEnv* env); // returns the run's state; NULL if the policy keeps none
+	void (*on_arrival)(void* state, int job, const P5PolicyJob* info);
+	int (*pick_next)(void* state, int64_t now, int64_t* slice);
+	void (*on_preempt)(void* state, int job, int64_t ran);
+	void (*on_complete)(void* state, int job, int64_t ran);
+	void (*fini)(void* state); // may be NULL
+}P5Policy;
+
+typedef const P5Policy* (*P5PolicyEntry)(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,328 @@
+// ******************************************************************************************************************
+//  CPU Scheduler
+//  Copyright(C) 2018  James LoForti
+//  Contact Info: jamesloforti@gmail.com
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.If not, see<https://www.gnu.org/licenses/>.
+//									     ____.           .____             _____  _______   
+//									    |    |           |    |    ____   /  |  | \   _  \  
+//									    |    |   ______  |    |   /  _ \ /   |  |_/  /_\  \ 
+//									/\__|    |  /_____/  |    |__(  <_> )    ^   /\  \_/   \
+//									\________|           |_______ \____/\____   |  \_____  /
+//									                             \/          |__|        \/ 
+//
+// ******************************************************************************************************************
+//
+
+//Packed workloads: arrivals stored as varint deltas and bursts as varints, in blocks that
+//can each be decoded on their own. Layout, every integer a LEB128 varint:
+//	file:	magic (4 bytes), jobs per block, total jobs, unit in nanoseconds (0 for abstract units), blocks...
+//	block:	job count, payload bytes, flags, first arrival, payload
+//	payload, per job: arrival delta from the previous job, burst, weight, task, affinity and deadline (each if flagged)
+
+#include <stdlib.h> 
+#include <stdio.h> // needed for fread()
+#include <string.h> // needed for memcmp()
+#include <limits.h> // needed for INT_MAX
+#include <inttypes.h> // needed for PRIu64
+#include "p5.h"
+
+void write_packed(FILE* out)
+{
+	//Groups live in the workload's group lines, which the packed form doesn't carry
+	if (groupCount > 1)
+	{
+		fprintf(stderr, "packed workloads can't carry fair share groups\n");
+		exit(1);
+	}
+
+	//Every value in a block takes at most 10 bytes
+	int blockJobs = PACKED_BLOCK;
+	unsigned char* payload = malloc((size_t)blockJobs * 6 * VARINT_MAX);
+	unsigned char header[4 * VARINT_MAX];
+
+	//File header
+	fwrite(PACKED_MAGIC, 1, 4, out);
+	int length = put_varint(header, blockJobs);
+	length += put_varint(header + length, numProcesses);
+	length += put_varint(header + length, (inputUnit != NULL) ? (uint64_t)inputUnit->nanoseconds : 0);
+	fwrite(header, 1, length, out);
+
+	//For every block of jobs
+	int first;
+	for (first = 0; first < numProcesses; first += blockJobs)
+	{
+		int count = (numProcesses - first < blockJobs) ? (numProcesses - first) : blockJobs;
+
+		//Only spend bytes on weights, tasks, affinities and deadlines when the block has any
+		int flags = 0;
+		int i;
+		for (i = first; i < first + count; i++)
+		{
+			flags |= (processes.weight[i] != 1) ? PACKED_WEIGHTS : 0;
+			flags |= (processes.task[i] != 0) ? PACKED_TASKS : 0;
+			flags |= (processes.affinity[i] != 0) ? PACKED_AFFINITY : 0;
+			flags |= (processes.deadline[i] != 0) ? PACKED_DEADLINES : 0;
+		}
+
+		//Encode the jobs
+		unsigned char* cursor = payload;
+		SimTime previous = processes.arrivalTime[first];
+		for (i = first; i < first + count; i++)
+		{
+			if (processes.arrivalTime[i] < previous || processes.burstTime[i] < 0)
+			{
+				fprintf(stderr, "process %d: packing needs sorted arrivals and non-negative bursts\n", i);
+				exit(1);
+			}
+
+			cursor += put_varint(cursor, (uint64_t)(processes.arrivalTime[i] - previous));
+			cursor += put_varint(cursor, (uint64_t)processes.burstTime[i]);
+			if (flags & PACKED_WEIGHTS)
+			{
+				cursor += put_varint(cursor, (uint64_t)processes.weight[i]);
+			}
+			if (flags & PACKED_TASKS)
+			{
+				cursor += put_varint(cursor, (uint64_t)processes.task[i]);
+			}
+			if (flags & PACKED_AFFINITY)
+			{
+				cursor += put_varint(cursor, processes.affinity[i]);
+			}
+			if (flags & PACKED_DEADLINES)
+			{
+				cursor += put_varint(cursor, (uint64_t)processes.deadline[i]);
+			}
+			previous = processes.arrivalTime[i];
+		} // end for
+
+		//Block header, then payload
+		length = put_varint(header, count);
+		length += put_varint(header + length, (uint64_t)(cursor - payload));
+		length += put_varint(header + length, flags);
+		length += put_varint(header + length, (uint64_t)processes.arrivalTime[first]);
+		fwrite(header, 1, length, out);
+		fwrite(payload, 1, cursor - payload, out);
+	} // end for
+
+	free(payload);
+	fflush(out);
+} // end function write_packed()
+
+void read_packed(FILE* in)
+{
+	unsigned char magic[4];
+	if (fread(magic, 1, 4, in) != 4 || memcmp(magic, PACKED_MAGIC, 4) != 0)
+	{
+		fprintf(stderr, "not a packed workload\n");
+		exit(1);
+	}
+
+	//File header, with the job counts held to what the table can index
+	uint64_t blockJobs = read_varint(in);
+	uint64_t totalJobs = read_varint(in);
+	uint64_t unit = read_varint(in);
+	if (blockJobs > INT_MAX || totalJobs > INT_MAX - 1)
+	{
+		fprintf(stderr, "corrupt packed workload\n");
+		exit(1);
+	}
+	inputUnit = NULL;
+	int i;
+	for (i = 0; timeUnits[i].name != NULL; i++)
+	{
+		if ((uint64_t)timeUnits[i].nanoseconds == unit)
+		{
+			inputUnit = &timeUnits[i];
+		}
+	}
+
+	//Size the table once for the whole workload
+	if (totalJobs + 1 > (uint64_t)processes.capacity)
+	{
+		int* pending = realloc(pendingSJF, sizeof(int) * (totalJobs + 1));
+		if (pending == NULL || !table_reserve(&processes, (int)totalJobs + 1))
+		{
+			fprintf(stderr, "out of memory for a packed workload of %" PRIu64 " jobs\n", totalJobs);
+			exit(1);
+		}
+		pendingSJF = pending;
+	}
+
+	unsigned char* payload = NULL;
+	size_t payloadCapacity = 0;
+
+	//For every block
+	int c;
+	while ((c = getc(in)) != EOF)
+	{
+		ungetc(c, in);
+
+		uint64_t count = read_varint(in);
+		uint64_t bytes = read_varint(in);
+		int flags = (int)read_varint(in);
+		SimTime base = (SimTime)read_varint(in);
+
+		//A block can't hold more jobs than the header allows, or more bytes than its fields take
+		int fields = 2 + !!(flags & PACKED_WEIGHTS) + !!(flags & PACKED_TASKS) + !!(flags & PACKED_AFFINITY) + !!(flags & PACKED_DEADLINES);
+		if (count > blockJobs || numProcesses + count > totalJobs || bytes > count * fields * VARINT_MAX)
+		{
+			fprintf(stderr, "corrupt packed workload\n");
+			exit(1);
+		}
+
+		//Pull in the whole block, then decode it straight into the table
+		if (bytes > payloadCapacity)
+		{
+			unsigned char* grown = realloc(payload, bytes);
+			if (grown == NULL)
+			{
+				fprintf(stderr, "out of memory for a packed block of %" PRIu64 " bytes\n", bytes);
+				exit(1);
+			}
+			payload = grown;
+			payloadCapacity = bytes;
+		}
+		if (fread(payload, 1, bytes, in) != bytes)
+		{
+			fprintf(stderr, "truncated packed workload\n");
+			exit(1);
+		}
+
+		decode_block(payload, payload + bytes, (int)count, flags, base);
+	} // end while
+
+	//Every job the header promised, no more and no fewer
+	if ((uint64_t)numProcesses != totalJobs)
+	{
+		fprintf(stderr, "corrupt packed workload\n");
+		exit(1);
+	}
+
+	free(payload);
+	finish_workload();
+} // end function read_packed()
+
+void decode_block(unsigned char* cursor, unsigned char* end, int count, int flags, SimTime arrival)
+{
+	//Make room for the whole block up front
+	int capacity = processes.capacity ? processes.capacity : MAX_PROCESSES;
+	while (numProcesses + count + 1 >= capacity)
+	{
+		capacity *= 2;
+	}
+	if (capacity != processes.capacity)
+	{
+		int* pending = realloc(pendingSJF, sizeof(int) * capacity);
+		if (pending == NULL || !table_reserve(&processes, capacity))
+		{
+			fprintf(stderr, "out of memory for a packed workload\n");
+			exit(1);
+		}
+		pendingSJF = pending;
+	}
+
+	//Rows may be left over from an earlier workload, so clear them and the spare past them
+#define CLEAR_COLUMN(type, name) \
+	memset(&processes.name[numProcesses], 0, sizeof(type) * (count + 1));
+	PROCESS_COLUMNS(CLEAR_COLUMN)
+#undef CLEAR_COLUMN
+
+	//Decode into the columns, only the fields a packed workload carries
+	SimTime* arrivals = processes.arrivalTime + numProcesses;
+	SimTime* bursts = processes.burstTime + numProcesses;
+	int i;
+	for (i = 0; i < count && cursor < end; i++)
+	{
+		arrival += (SimTime)get_varint(&cursor, end);
+		arrivals[i] = arrival;
+		bursts[i] = (SimTime)get_varint(&cursor, end);
+		processes.weight[numProcesses + i] = (flags & PACKED_WEIGHTS) ? (int)get_varint(&cursor, end) : 1;
+		processes.task[numProcesses + i] = (flags & PACKED_TASKS) ? (int)get_varint(&cursor, end) : 0;
+		processes.affinity[numProcesses + i] = (flags & PACKED_AFFINITY) ? get_varint(&cursor, end) : 0;
+		processes.deadline[numProcesses + i] = (flags & PACKED_DEADLINES) ? (SimTime)get_varint(&cursor, end) : 0;
+	} // end for
+
+	if (i != count)
+	{
+		fprintf(stderr, "corrupt packed workload\n");
+		exit(1);
+	}
+
+	numProcesses += count;
+} // end function decode_block()
+
+int put_varint(unsigned char* buffer, uint64_t value)
+{
+	//Seven bits at a time, high bit set on all but the last byte
+	int length = 0;
+	while (value >= 0x80)
+	{
+		buffer[length++] = (unsigned char)(value | 0x80);
+		value >>= 7;
+	}
+	buffer[length++] = (unsigned char)value;
+
+	return length;
+} // end function put_varint()
+
+uint64_t get_varint(unsigned char** cursor, unsigned char* end)
+{
+	unsigned char* p = *cursor;
+
+	//Most values in a workload fit in one byte
+	if (p < end && p[0] < 0x80)
+	{
+		*cursor = p + 1;
+		return p[0];
+	}
+
+	//A corrupt value may run past the payload, or past the ten bytes any 64-bit value needs
+	uint64_t value = 0;
+	int shift = 0;
+	do
+	{
+		if (p >= end || shift > 63)
+		{
+			fprintf(stderr, "corrupt packed workload\n");
+			exit(1);
+		}
+		value |= (uint64_t)(*p & 0x7f) << shift;
+		shift += 7;
+	} while (*p++ & 0x80);
+
+	*cursor = p;
+	return value;
+} // end function get_varint()
+
+uint64_t read_varint(FILE* in)
+{
+	uint64_t value = 0;
+	int shift = 0;
+	int c;
+	do
+	{
+		c = getc(in);
+		if (c == EOF || shift > 63)
+		{
+			fprintf(stderr, "truncated packed workload\n");
+			exit(1);
+		}
+		value |= (uint64_t)(c & 0x7f) << shift;
+		shift += 7;
+	} while (c & 0x80);
+
+	return value;
+} // end function read_varint()
@@ -0,0 +1,127 @@
+// ******************************************************************************************************************
+//  CPU Scheduler
+//  Copyright(C) 2018  James LoForti
+//  Contact Info: jamesloforti@gmail.com
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.If not, see<https://www.gnu.org/licenses/>.
+//									     ____.           .____             _____  _______   
+//									    |    |           |    |    ____   /  |  | \   _  \  
+//									    |    |   ______  |    |   /  _ \ /   |  |_/  /_\  \ 
+//									/\__|    |  /_____/  |    |__(  <_> )    ^   /\  \_/   \
+//									\________|           |_______ \____/\____   |  \_____  /
+//									                             \/          |__|        \/ 
+//
+// ******************************************************************************************************************
+//
+//Policy plugins: a shared object named with -l exports a P5Policy (see p5policy.h), which is
+//checked against the engine's ABI and registered in a spare slot of the policy table, so
+//every front end finds it by name like a built in. The table's run functions take no
+//arguments, so each slot gets a run function of its own that hands its number over.
+//Plugins are loaded before any run starts and stay loaded, shared by every thread
+
+#include <stdlib.h> 
+#include <stdio.h> // needed for snprintf()
+#include <string.h> // needed for strcmp()
+#include <inttypes.h> // needed for PRId64
+#include <dlfcn.h> // needed for dlopen()
+#include "p5.h"
+
+//Plugin globals
+const P5Policy* plugins[MAX_PLUGINS];
+int pluginCount;
+char pluginError[256]; // why the last load failed
+
+//One run function per plugin slot
+#define PLUGIN_SLOTS(SLOT) SLOT(0) SLOT(1) SLOT(2) SLOT(3) SLOT(4) SLOT(5) SLOT(6) SLOT(7)
+#define PLUGIN_RUN(slot) void run_plugin_##slot() { run_plugin(slot); }
+PLUGIN_SLOTS(PLUGIN_RUN)
+#define PLUGIN_ENTRY(slot) run_plugin_##slot,
+void (*pluginRuns[MAX_PLUGINS])() = { PLUGIN_SLOTS(PLUGIN_ENTRY) };
+
+int load_plugin(char* path)
+{
+	if (pluginCount == MAX_PLUGINS)
+	{
+		snprintf(pluginError, sizeof(pluginError), "no more than %d plugins", MAX_PLUGINS);
+		return 0;
+	}
+
+	//A bare file name would be searched for on the library path, so anchor it here
+	char local[4096];
+	snprintf(local, sizeof(local), "%s%s", (strchr(path, '/') == NULL) ? "./" : "", path);
+	void* library = dlopen(local, RTLD_NOW | RTLD_LOCAL);
+	if (library == NULL)
+	{
+		snprintf(pluginError, sizeof(pluginError), "%s", dlerror());
+		return 0;
+	}
+
+	P5PolicyEntry entry = (P5PolicyEntry)dlsym(library, P5_POLICY_SYMBOL);
+	const P5Policy* policy = (entry != NULL) ? entry() : NULL;
+	if (policy == NULL)
+	{
+		snprintf(pluginError, sizeof(pluginError), "no %s() returning a policy", P5_POLICY_SYMBOL);
+		dlclose(library);
+		return 0;
+	}
+
+	//Refuse anything built against another interface, or missing a callback the engine needs
+	if (policy->abi != P5_POLICY_ABI)
+	{
+		snprintf(pluginError, sizeof(pluginError), "built for policy ABI %d, this is %d", policy->abi, P5_POLICY_ABI);
+		dlclose(library);
+		return 0;
+	}
+	if (policy->name == NULL || !policy->name[0] || strchr(policy->name, ',') != NULL
+		|| policy->on_arrival == NULL || policy->pick_next == NULL || policy->on_preempt == NULL || policy->on_complete == NULL)
+	{
+		snprintf(pluginError, sizeof(pluginError), "needs a name without commas and every callback but init and fini");
+		dlclose(library);
+		return 0;
+	}
+	if (find_policy((char*)policy->name) != NULL)
+	{
+		snprintf(pluginError, sizeof(pluginError), "there's already a policy named '%s'", policy->name);
+		dlclose(library);
+		return 0;
+	}
+
+	//Take the first free slot of the policy table, keeping a terminator after it
+	int i = 0;
+	while (policies[i].name != NULL)
+	{
+		i++;
+	} // end while
+	if (i + 1 >= POLICY_SLOTS)
+	{
+		snprintf(pluginError, sizeof(pluginError), "the policy table is full");
+		dlclose(library);
+		return 0;
+	}
+
+	plugins[pluginCount] = policy;
+	policies[i].name = (char*)policy->name;
+	policies[i].run = pluginRuns[pluginCount];
+	policies[i].resume = NULL;
+	policies[i].uses = USES_QUANTUM | USES_SEED | USES_INTERVAL | USES_PLUGIN;
+	pluginCount++;
+	return 1;
+} // end function load_plugin()
+
+void run_plugin(int slot)
+{
+	char label[128];
+	snprintf(label, sizeof(label), "%.64s (plugin, w/ quantum %" PRId64 ")", plugins[slot]->name, quantum);
+	run_share(label, plugins[slot]);
+} // end function run_plugin()
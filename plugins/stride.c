@@ -0,0 +1,153 @@
+// ******************************************************************************************************************
+//  CPU Scheduler
+//  Copyright(C) 2018  James LoForti
+//  Contact Info: jamesloforti@gmail.com
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.If not, see<https://www.gnu.org/licenses/>.
+//									     ____.           .____             _____  _______   
+//									    |    |           |    |    ____   /  |  | \   _  \  
+//									    |    |   ______  |    |   /  _ \ /   |  |_/  /_\  \ 
+//									/\__|    |  /_____/  |    |__(  <_> )    ^   /\  \_/   \
+//									\________|           |_______ \____/\____   |  \_____  /
+//									                             \/          |__|        \/ 
+//
+// ******************************************************************************************************************
+//
+//Example policy plugin: stride scheduling written against p5policy.h alone, with the same
+//passes and tie breaks as the built in stride, so the two schedules match. Build and run:
+//	make plugins/stride.so
+//	./p5 -l plugins/stride.so -a stride,stride-plugin < data.txt
+
+#include <stdlib.h> 
+#include "p5policy.h"
+
+#define STRIDE1 (1 << 20)
+
+//Everything for one run, since runs on other threads have their own
+typedef struct strideState
+{
+	int64_t quantum;
+	int* weight;
+	long long* pass;
+	int* heap; // run queue, keyed on pass then job
+	int heapCount;
+	long long globalPass;
+}StrideState;
+
+static int heap_less(StrideState* self, int a, int b)
+{
+	//Order by pass, then by job so ties break deterministically
+	if (self->pass[a] != self->pass[b])
+	{
+		return self->pass[a] < self->pass[b];
+	}
+	return a < b;
+} // end function heap_less()
+
+static void heap_push(StrideState* self, int job)
+{
+	//Sift the new entry up from the bottom
+	int i = self->heapCount++;
+	while (i > 0 && heap_less(self, job, self->heap[(i - 1) / 2]))
+	{
+		self->heap[i] = self->heap[(i - 1) / 2];
+		i = (i - 1) / 2;
+	}
+	self->heap[i] = job;
+} // end function heap_push()
+
+static int heap_pop(StrideState* self)
+{
+	int top = self->heap[0];
+	int last = self->heap[--self->heapCount];
+
+	//Sift the last entry down from the top
+	int i = 0;
+	while ((2 * i) + 1 < self->heapCount)
+	{
+		int child = (2 * i) + 1;
+		if (child + 1 < self->heapCount && heap_less(self, self->heap[child + 1], self->heap[child]))
+		{
+			child++;
+		}
+
+		if (!heap_less(self, self->heap[child], last))
+		{
+			break;
+		}
+
+		self->heap[i] = self->heap[child];
+		i = child;
+	} // end while
+	self->heap[i] = last;
+
+	return top;
+} // end function heap_pop()
+
+static void* init(const P5PolicyEnv* env)
+{
+	StrideState* self = calloc(1, sizeof(StrideState));
+	int rows = (env->jobs > 0) ? env->jobs : 1;
+	self->quantum = env->quantum;
+	self->weight = malloc(sizeof(int) * rows);
+	self->pass = malloc(sizeof(long long) * rows);
+	self->heap = malloc(sizeof(int) * rows);
+	return self;
+} // end function init()
+
+static void on_arrival(void* state, int job, const P5PolicyJob* info)
+{
+	//Newcomers start level with the current pass, so they can't monopolize the cpu
+	StrideState* self = state;
+	self->weight[job] = info->weight;
+	self->pass[job] = self->globalPass;
+	heap_push(self, job);
+} // end function on_arrival()
+
+static int pick_next(void* state, int64_t now, int64_t* slice)
+{
+	StrideState* self = state;
+	int job = heap_pop(self);
+	self->globalPass = self->pass[job];
+	return job;
+} // end function pick_next()
+
+static void on_preempt(void* state, int job, int64_t ran)
+{
+	//Advance pass in proportion to the slice actually used
+	StrideState* self = state;
+	self->pass[job] += ((long long)(STRIDE1 / self->weight[job]) * ran) / self->quantum;
+	heap_push(self, job);
+} // end function on_preempt()
+
+static void on_complete(void* state, int job, int64_t ran)
+{
+	//Finished job was already popped from the run queue
+} // end function on_complete()
+
+static void fini(void* state)
+{
+	StrideState* self = state;
+	free(self->weight);
+	free(self->pass);
+	free(self->heap);
+	free(self);
+} // end function fini()
+
+static const P5Policy stridePlugin = { P5_POLICY_ABI, "stride-plugin", init, on_arrival, pick_next, on_preempt, on_complete, fini };
+
+P5_POLICY_EXPORT const P5Policy* p5_policy(void)
+{
+	return &stridePlugin;
+} // end function p5_policy()
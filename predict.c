@@ -0,0 +1,178 @@
+// ******************************************************************************************************************
+//  CPU Scheduler
+//  Copyright(C) 2018  James LoForti
+//  Contact Info: jamesloforti@gmail.com
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.If not, see<https://www.gnu.org/licenses/>.
+//									     ____.           .____             _____  _______   
+//									    |    |           |    |    ____   /  |  | \   _  \  
+//									    |    |   ______  |    |   /  _ \ /   |  |_/  /_\  \ 
+//									/\__|    |  /_____/  |    |__(  <_> )    ^   /\  \_/   \
+//									\________|           |_______ \____/\____   |  \_____  /
+//									                             \/          |__|        \/ 
+//
+// ******************************************************************************************************************
+//
+
+//Predicted burst scheduling: sjf and srtf as a real kernel could run them, ordering jobs by
+//an estimate of their burst instead of the burst itself. Each task's next burst is guessed
+//by exponential averaging over its earlier jobs, tau = alpha * burst + (1 - alpha) * tau,
+//starting from an initial guess. Untraced jobs (task 0) share one history. Estimates are
+//made once, when the workload is read, so they ride along with the table into copies and
+//checkpoints. psrtf counts the estimate down as the job runs, so a job that outruns its
+//guess looks nearly done
+
+#include <stdlib.h> 
+#include <stdio.h> // needed for printf()
+#include <string.h> // needed for memset()
+#include "p5.h"
+
+//Prediction globals
+PER_THREAD int predictBursts; // order by the predicted column instead of the burst
+PER_THREAD double predictAlpha = PREDICT_ALPHA;
+PER_THREAD SimTime predictInitial; // guess for a task's first job, 0 = one quantum
+PER_THREAD double predictionError; // mean absolute error of the last predictions
+PER_THREAD double predictionBias; // mean of predicted minus actual
+PER_THREAD double predictionBurst; // mean actual burst, to put the error in proportion
+PER_THREAD int predictionCount; // jobs the figures above cover, 0 if none yet
+
+int parse_prediction(char* text)
+{
+	//alpha[:initial]
+	long long initial = 0;
+	int fields = sscanf(text, "%lf:%lld", &predictAlpha, &initial);
+	if (fields < 1 || predictAlpha <= 0 || predictAlpha > 1 || (fields == 2 && initial < 1))
+	{
+		return 0;
+	}
+
+	predictInitial = (SimTime)initial;
+	return 1;
+} // end function parse_prediction()
+
+void psjf()
+{
+	predictBursts = 1;
+	sjf();
+	predictBursts = 0;
+} // end function psjf()
+
+void psrtf()
+{
+	predictBursts = 1;
+	srtf();
+	predictBursts = 0;
+} // end function psrtf()
+
+void resume_psrtf()
+{
+	predictBursts = 1;
+	run_srtf();
+	predictBursts = 0;
+} // end function resume_psrtf()
+
+void predict_bursts()
+{
+	//Walk each task's jobs in arrival order. Pids are already by arrival, so untraced
+	//workloads are one pass; otherwise sort by task, keeping arrival order within each
+	int* order = malloc(sizeof(int) * (numProcesses + 1));
+	int traced = 0;
+	int i;
+	for (i = 0; i < numProcesses; i++)
+	{
+		order[i] = i;
+		traced |= processes.task[i];
+	}
+	if (traced)
+	{
+		qsort(order, numProcesses, sizeof(int), compare_task);
+	}
+
+	SimTime initial = predictInitial ? predictInitial : quantum;
+	double tau = initial;
+	long double sumError = 0;
+	long double sumBias = 0;
+	long double sumBurst = 0;
+	for (i = 0; i < numProcesses; i++)
+	{
+		int pid = order[i];
+
+		//A new task starts from the initial guess
+		if (i == 0 || processes.task[pid] != processes.task[order[i - 1]])
+		{
+			tau = initial;
+		}
+
+		//Round to whole time units, never below one
+		SimTime guess = (SimTime)(tau + 0.5);
+		processes.predicted[pid] = (guess > 0) ? guess : 1;
+
+		SimTime burst = processes.burstTime[pid];
+		SimTime miss = processes.predicted[pid] - burst;
+		sumError += (miss < 0) ? -miss : miss;
+		sumBias += miss;
+		sumBurst += burst;
+
+		//Fold this burst into the task's history
+		tau = (predictAlpha * burst) + ((1 - predictAlpha) * tau);
+	} // end for
+
+	predictionCount = numProcesses;
+	predictionError = numProcesses ? (double)(sumError / numProcesses) : 0;
+	predictionBias = numProcesses ? (double)(sumBias / numProcesses) : 0;
+	predictionBurst = numProcesses ? (double)(sumBurst / numProcesses) : 0;
+
+	free(order);
+} // end function predict_bursts()
+
+char* prediction_label(char* label, char* buffer, size_t size)
+{
+	//Plain sjf and srtf keep their names
+	if (!predictBursts)
+	{
+		return label;
+	}
+
+	snprintf(buffer, size, "Predicted %s (w/ alpha %.2f)", label, predictAlpha);
+	return buffer;
+} // end function prediction_label()
+
+void print_prediction()
+{
+	//Nothing was read in this thread
+	if (!predictionCount)
+	{
+		return;
+	}
+
+	//Label times with their unit, when the workload declared one
+	char* unit = (outputUnit != NULL) ? outputUnit->name : "";
+	char* space = (outputUnit != NULL) ? " " : "";
+
+	printf("\tPrediction Error: %.2f%s%s mean absolute (%.1f%% of the mean burst), %+.2f%s%s bias\n",
+			to_output_unit(predictionError), space, unit, predictionBurst ? (100 * predictionError / predictionBurst) : 0,
+			to_output_unit(predictionBias), space, unit);
+} // end function print_prediction()
+
+int compare_task(const void* a, const void* b)
+{
+	int left = *(const int*)a;
+	int right = *(const int*)b;
+
+	if (processes.task[left] != processes.task[right])
+	{
+		return (processes.task[left] < processes.task[right]) ? -1 : 1;
+	}
+	return left - right;
+} // end function compare_task()
@@ -0,0 +1,390 @@
+// ******************************************************************************************************************
+//  CPU Scheduler
+//  Copyright(C) 2018  James LoForti
+//  Contact Info: jamesloforti@gmail.com
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.If not, see<https://www.gnu.org/licenses/>.
+//									     ____.           .____             _____  _______   
+//									    |    |           |    |    ____   /  |  | \   _  \  
+//									    |    |   ______  |    |   /  _ \ /   |  |_/  /_\  \ 
+//									/\__|    |  /_____/  |    |__(  <_> )    ^   /\  \_/   \
+//									\________|           |_______ \____/\____   |  \_____  /
+//									                             \/          |__|        \/ 
+//
+// ******************************************************************************************************************
+//
+
+//Replication: run the policies over many variants of a workload and report each metric's
+//mean with a 95% confidence interval. Variants are either generated from a distribution
+//(-g jobs:gap:burst[:alpha]: exponential gaps between arrivals, and bursts that are
+//exponential, or Pareto with shape alpha) or bootstrap resampled from the workload read in:
+//jobs drawn with replacement, each keeping the gap to the job before it, so the arrival
+//rate and the burst mix carry over. Every policy sees the same variants, so differences
+//between policies are compared pair by pair. Replicas run in parallel, one per worker
+//thread at a time, and each replica's seed depends only on its number
+
+#include <stdlib.h> 
+#include <stdio.h> // needed for printf()
+#include <string.h> // needed for strtok()
+#include <math.h> // needed for sqrt()
+#include <pthread.h> // needed for the worker pool
+#include "p5.h"
+
+//Replication globals, shared by the workers
+int replicaCount;
+int replicaPolicies;
+Policy** replicaPolicy; // policies to run, in the order asked for
+double* replicaMetrics; // [replica][policy][metric]
+int nextReplica;
+pthread_mutex_t replicaLock = PTHREAD_MUTEX_INITIALIZER;
+int generateJobs; // 0 to resample the workload read in
+double generateGap;
+double generateBurst;
+double generateAlpha; // 0 for exponential bursts
+ProcessTable sourceRows; // the workload read in
+int sourceCount;
+unsigned long long replicaSeed;
+
+//Settings from the command line, which live in the main thread's globals
+SimTime replicaQuantum;
+SimTime replicaInterval;
+int replicaCapacity;
+char* replicaAdmission;
+double replicaAlpha;
+SimTime replicaInitial;
+SimTime replicaSlices[3]; // adaptive rr's shortest and longest slice, and its latency
+TimeUnit* replicaInputUnit;
+TimeUnit* replicaOutputUnit;
+
+char* replicaMetricNames[REPLICA_METRICS] =
+{
+	"AVG Response Time",
+	"AVG Turnaround Time",
+	"AVG Wait Time",
+	"MAX Turnaround Time"
+};
+
+int parse_generator(char* text)
+{
+	//jobs:gap:burst[:alpha]
+	generateAlpha = 0;
+	int fields = sscanf(text, "%d:%lf:%lf:%lf", &generateJobs, &generateGap, &generateBurst, &generateAlpha);
+	if (fields < 3 || generateJobs <= 0 || generateGap < 0 || generateBurst < 1)
+	{
+		return 0;
+	}
+
+	//A Pareto tail needs a finite mean
+	return (fields == 3 || generateAlpha > 1);
+} // end function parse_generator()
+
+int replicate(char* algorithms, int replicas, int workers)
+{
+	//Policies, in the order asked for
+	replicaPolicy = malloc(sizeof(Policy*) * (strlen(algorithms) + 1));
+	replicaPolicies = 0;
+	char* name;
+	for (name = strtok(algorithms, ","); name != NULL; name = strtok(NULL, ","))
+	{
+		replicaPolicy[replicaPolicies++] = find_policy(name);
+	}
+
+	//Keep the workload read in, if it's the one being resampled
+	if (!generateJobs)
+	{
+		sourceCount = numProcesses;
+		table_reserve(&sourceRows, numProcesses + 1);
+		table_copy(&sourceRows, &processes, numProcesses + 1);
+	}
+
+	//Hand the command line settings over to the workers
+	replicaQuantum = quantum;
+	replicaInterval = shareInterval;
+	replicaCapacity = queueCapacity;
+	replicaAdmission = admission;
+	replicaAlpha = predictAlpha;
+	replicaInitial = predictInitial;
+	replicaSlices[0] = adaptiveMin;
+	replicaSlices[1] = adaptiveMax;
+	replicaSlices[2] = adaptiveLatency;
+	replicaInputUnit = generateJobs ? NULL : inputUnit;
+	replicaOutputUnit = generateJobs ? NULL : outputUnit;
+	replicaSeed = randomState;
+	replicaCount = replicas;
+	nextReplica = 0;
+	replicaMetrics = malloc(sizeof(double) * replicas * replicaPolicies * REPLICA_METRICS);
+
+	//Work through the replicas in parallel
+	workers = (workers < replicas) ? workers : replicas;
+	pthread_t* threads = malloc(sizeof(pthread_t) * workers);
+	int i;
+	for (i = 0; i < workers; i++)
+	{
+		if (pthread_create(&threads[i], NULL, replica_worker, NULL) != 0)
+		{
+			perror("pthread_create");
+			return 1;
+		}
+	} // end for
+	for (i = 0; i < workers; i++)
+	{
+		pthread_join(threads[i], NULL);
+	}
+
+	print_replicas();
+
+	free(threads);
+	free(replicaMetrics);
+	free(replicaPolicy);
+	table_destructor(&sourceRows);
+	return 0;
+} // end function replicate()
+
+void* replica_worker(void* unused)
+{
+	//Take on the command line settings, quietly
+	quantum = replicaQuantum;
+	shareInterval = replicaInterval;
+	queueCapacity = replicaCapacity;
+	admission = replicaAdmission;
+	predictAlpha = replicaAlpha;
+	predictInitial = replicaInitial;
+	adaptiveMin = replicaSlices[0];
+	adaptiveMax = replicaSlices[1];
+	adaptiveLatency = replicaSlices[2];
+	inputUnit = replicaInputUnit;
+	outputUnit = replicaOutputUnit;
+	quiet = 1;
+
+	ProcessTable pristine = { 0 };
+
+	for (;;)
+	{
+		//Claim the next replica
+		pthread_mutex_lock(&replicaLock);
+		int replica = nextReplica++;
+		pthread_mutex_unlock(&replicaLock);
+		if (replica >= replicaCount)
+		{
+			break;
+		}
+
+		//Build this replica's workload, and keep a copy for each policy to start from
+		unsigned long long state = replica_stream(replica);
+		if (generateJobs)
+		{
+			generate_replica(&state);
+		}
+		else
+		{
+			resample_replica(&state);
+		}
+		table_reserve(&pristine, processes.capacity);
+		table_copy(&pristine, &processes, numProcesses + 1);
+
+		//Run every policy over it
+		int p;
+		for (p = 0; p < replicaPolicies; p++)
+		{
+			table_copy(&processes, &pristine, numProcesses + 1);
+			randomState = replicaSeed;
+			init_all();
+			replicaPolicy[p]->run();
+
+			double* metrics = &replicaMetrics[((size_t)replica * replicaPolicies + p) * REPLICA_METRICS];
+			metrics[0] = summary.responseTime;
+			metrics[1] = summary.turnTime;
+			metrics[2] = summary.waitTime;
+			metrics[3] = summary.maxTurnTime;
+		} // end for
+	} // end for
+
+	table_destructor(&pristine);
+	return unused;
+} // end function replica_worker()
+
+unsigned long long replica_stream(int replica)
+{
+	//splitmix64 over the seed and the replica number, so no two replicas share a stream
+	unsigned long long z = replicaSeed + (0x9E3779B97F4A7C15ULL * (unsigned long long)(replica + 1));
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	z ^= z >> 31;
+	return z ? z : 1;
+} // end function replica_stream()
+
+double replica_uniform(unsigned long long* state)
+{
+	//xorshift64*, top 53 bits, strictly between 0 and 1
+	*state ^= *state >> 12;
+	*state ^= *state << 25;
+	*state ^= *state >> 27;
+	unsigned long long bits = (*state * 2685821657736338717ULL) >> 11;
+	return (bits + 0.5) / 9007199254740992.0;
+} // end function replica_uniform()
+
+void generate_replica(unsigned long long* state)
+{
+	numProcesses = 0;
+	double arrival = 0;
+
+	int i;
+	for (i = 0; i < generateJobs; i++)
+	{
+		//Poisson arrivals
+		arrival += -generateGap * log(replica_uniform(state));
+
+		//Exponential bursts, or Pareto with the same mean
+		double burst;
+		if (generateAlpha > 0)
+		{
+			double scale = generateBurst * (generateAlpha - 1) / generateAlpha;
+			burst = scale / pow(replica_uniform(state), 1 / generateAlpha);
+		}
+		else
+		{
+			burst = -generateBurst * log(replica_uniform(state));
+		}
+
+		add_process((SimTime)arrival, (burst < 1) ? 1 : (SimTime)(burst + 0.5));
+	} // end for
+
+	finish_workload();
+} // end function generate_replica()
+
+void resample_replica(unsigned long long* state)
+{
+	numProcesses = 0;
+	SimTime arrival = sourceRows.arrivalTime[0];
+
+	int i;
+	for (i = 0; i < sourceCount; i++)
+	{
+		//Draw a job, keeping the gap that led up to it
+		int j = (int)(replica_uniform(state) * sourceCount);
+		arrival += j ? (sourceRows.arrivalTime[j] - sourceRows.arrivalTime[j - 1]) : 0;
+
+		int pid = add_process(arrival, sourceRows.burstTime[j]);
+		processes.weight[pid] = sourceRows.weight[j];
+		processes.task[pid] = sourceRows.task[j];
+		processes.affinity[pid] = sourceRows.affinity[j];
+		processes.deadline[pid] = sourceRows.deadline[j];
+	} // end for
+
+	finish_workload();
+} // end function resample_replica()
+
+void print_replicas()
+{
+	//Label times with their unit, when the workload declared one
+	char* unit = (replicaOutputUnit != NULL) ? replicaOutputUnit->name : "";
+	char* space = (replicaOutputUnit != NULL) ? " " : "";
+
+	if (generateJobs)
+	{
+		printf("\nReplicated over %d generated workloads of %d jobs, 95%% confidence intervals:\n", replicaCount, generateJobs);
+	}
+	else
+	{
+		printf("\nReplicated over %d bootstrap resamples of the workload, 95%% confidence intervals:\n", replicaCount);
+	}
+
+	double* samples = malloc(sizeof(double) * replicaCount);
+	int p, m, r;
+	for (p = 0; p < replicaPolicies; p++)
+	{
+		printf("\n%s:\n", replicaPolicy[p]->name);
+
+		for (m = 0; m < REPLICA_METRICS; m++)
+		{
+			for (r = 0; r < replicaCount; r++)
+			{
+				samples[r] = replica_metric(r, p, m);
+			}
+
+			double mean, half;
+			confidence_interval(samples, replicaCount, &mean, &half);
+			printf("\t%s: %.2f +/- %.2f%s%s\n", replicaMetricNames[m], mean, half, space, unit);
+		} // end for
+
+		//Against the first policy, replica by replica, which cancels the shared workload noise
+		if (p == 0)
+		{
+			continue;
+		}
+		for (m = 0; m < REPLICA_METRICS; m++)
+		{
+			for (r = 0; r < replicaCount; r++)
+			{
+				samples[r] = replica_metric(r, p, m) - replica_metric(r, 0, m);
+			}
+
+			double mean, half;
+			confidence_interval(samples, replicaCount, &mean, &half);
+			printf("\t%s vs %s: %+.2f +/- %.2f%s%s%s\n", replicaMetricNames[m], replicaPolicy[0]->name, mean, half, space, unit,
+					(fabs(mean) > half) ? "" : " (not significant)");
+		} // end for
+	} // end for
+
+	free(samples);
+} // end function print_replicas()
+
+double replica_metric(int replica, int policy, int metric)
+{
+	return replicaMetrics[((size_t)replica * replicaPolicies + policy) * REPLICA_METRICS + metric];
+} // end function replica_metric()
+
+void confidence_interval(double* samples, int count, double* mean, double* half)
+{
+	double sum = 0;
+	int i;
+	for (i = 0; i < count; i++)
+	{
+		sum += samples[i];
+	}
+	*mean = sum / count;
+
+	//One sample says nothing about the spread
+	if (count < 2)
+	{
+		*half = 0;
+		return;
+	}
+
+	double squares = 0;
+	for (i = 0; i < count; i++)
+	{
+		squares += (samples[i] - *mean) * (samples[i] - *mean);
+	}
+	*half = t_critical(count - 1) * sqrt(squares / (count - 1)) / sqrt(count);
+} // end function confidence_interval()
+
+double t_critical(int df)
+{
+	//Two sided 95% points of Student's t
+	static const double table[30] =
+	{
+		12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+		2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+		2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+	};
+	if (df <= 30)
+	{
+		return table[df - 1];
+	}
+
+	//Past the table, the normal point with the first correction term
+	double z = 1.959964;
+	return z + ((z * z * z) + z) / (4.0 * df);
+} // end function t_critical()
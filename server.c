@@ -0,0 +1,329 @@
+// ******************************************************************************************************************
+//  CPU Scheduler
+//  Copyright(C) 2018  James LoForti
+//  Contact Info: jamesloforti@gmail.com
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.If not, see<https://www.gnu.org/licenses/>.
+//									     ____.           .____             _____  _______   
+//									    |    |           |    |    ____   /  |  | \   _  \  
+//									    |    |   ______  |    |   /  _ \ /   |  |_/  /_\  \ 
+//									/\__|    |  /_____/  |    |__(  <_> )    ^   /\  \_/   \
+//									\________|           |_______ \____/\____   |  \_____  /
+//									                             \/          |__|        \/ 
+//
+// ******************************************************************************************************************
+//
+
+//Server mode: answers what-if requests on a Unix domain socket. A pool of worker threads
+//each keeps its engine state, process table and queue nodes warm between requests.
+//
+//Protocol, one or more requests per connection, all lines newline terminated:
+//	run policy=<name> [quantum=<q>] [seed=<s>] [alpha=<a>] [initial=<i>] [min=<m> max=<m> [latency=<l>]]
+//		[queue=<capacity>] [admission=<reject|oldest|priority|deadline>] [tick=<t> [cost=<c>] [tickless=1]] [jobs=1]
+//	<arrival> <burst> [weight=<w>] [task=<t>] [deadline=<d>]
+//	...
+//	end
+//The settings are P5Config's, with the same defaults and limits. Reply:
+//	ok count=<n> response=<avg> turnaround=<avg> wait=<avg> makespan=<t> shed=<n>
+//	job <pid> <start> <end> <response> <turnaround> <wait> <shed>	(one per job, if jobs=1)
+//	end
+//or "error <reason>" followed by "end".
+
+#include <stdlib.h> 
+#include <stdio.h> // needed for fprintf()
+#include <string.h> // needed for strtok_r()
+#include <inttypes.h> // needed for PRId64, SCNd64
+#include <unistd.h> // needed for close()
+#include <signal.h> // needed for signal()
+#include <pthread.h> // needed for the worker pool
+#include <sys/socket.h>
+#include <sys/un.h> // needed for sockaddr_un
+#include "p5.h"
+#include "p5lib.h"
+
+//Connections accepted but not yet picked up by a worker
+int pendingFds[SERVER_BACKLOG];
+int pendingHead;
+int pendingCount;
+pthread_mutex_t pendingLock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t pendingReady = PTHREAD_COND_INITIALIZER;
+pthread_cond_t pendingRoom = PTHREAD_COND_INITIALIZER;
+
+int serve(char* path, int workers)
+{
+	//A client hanging up mid reply shouldn't take the server down
+	signal(SIGPIPE, SIG_IGN);
+
+	//Bind the socket, replacing any stale one left by an earlier run
+	struct sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (strlen(path) >= sizeof(address.sun_path))
+	{
+		fprintf(stderr, "%s: socket path too long\n", path);
+		return 1;
+	}
+	strcpy(address.sun_path, path);
+
+	int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+	unlink(path);
+	if (listener < 0 || bind(listener, (struct sockaddr*)&address, sizeof(address)) != 0 || listen(listener, SERVER_BACKLOG) != 0)
+	{
+		perror(path);
+		return 1;
+	}
+
+	//Start the worker pool
+	int i;
+	for (i = 0; i < workers; i++)
+	{
+		pthread_t thread;
+		if (pthread_create(&thread, NULL, serve_worker, NULL) != 0)
+		{
+			perror("pthread_create");
+			return 1;
+		}
+		pthread_detach(thread);
+	} // end for
+
+	fprintf(stderr, "serving on %s with %d workers\n", path, workers);
+
+	//Hand every connection to the pool
+	for (;;)
+	{
+		int fd = accept(listener, NULL, NULL);
+		if (fd < 0)
+		{
+			continue;
+		}
+
+		pthread_mutex_lock(&pendingLock);
+		while (pendingCount == SERVER_BACKLOG)
+		{
+			pthread_cond_wait(&pendingRoom, &pendingLock);
+		}
+		pendingFds[(pendingHead + pendingCount++) % SERVER_BACKLOG] = fd;
+		pthread_cond_signal(&pendingReady);
+		pthread_mutex_unlock(&pendingLock);
+	} // end for
+} // end function serve()
+
+void* serve_worker(void* unused)
+{
+	//Job buffer, grown as needed and kept for the life of the thread
+	P5Job* jobs = NULL;
+	int capacity = 0;
+
+	for (;;)
+	{
+		//Wait for a connection
+		pthread_mutex_lock(&pendingLock);
+		while (pendingCount == 0)
+		{
+			pthread_cond_wait(&pendingReady, &pendingLock);
+		}
+		int fd = pendingFds[pendingHead];
+		pendingHead = (pendingHead + 1) % SERVER_BACKLOG;
+		pendingCount--;
+		pthread_cond_signal(&pendingRoom);
+		pthread_mutex_unlock(&pendingLock);
+
+		serve_connection(fd, &jobs, &capacity);
+	} // end for
+
+	return unused;
+} // end function serve_worker()
+
+void serve_connection(int fd, P5Job** jobs, int* capacity)
+{
+	FILE* in = fdopen(fd, "r");
+	FILE* out = fdopen(dup(fd), "w");
+	if (in == NULL || out == NULL)
+	{
+		close(fd);
+		return;
+	}
+
+	char* line = NULL;
+	size_t length = 0;
+
+	//For every request on the connection
+	while (getline(&line, &length, in) != -1)
+	{
+		//Skip anything that isn't the start of a request
+		if (strncmp(line, "run", 3) != 0)
+		{
+			continue;
+		}
+
+		//Read the policy config
+		char policy[32] = "";
+		char shedding[16] = "";
+		P5Config config = { policy, 0, 0 };
+		int detail = 0;
+		char* error = NULL;
+		char* save;
+		char* token;
+		for (token = strtok_r(line + 3, " \t\r\n", &save); token != NULL; token = strtok_r(NULL, " \t\r\n", &save))
+		{
+			if (strncmp(token, "policy=", 7) == 0)
+			{
+				snprintf(policy, sizeof(policy), "%s", token + 7);
+			}
+			else if (strncmp(token, "quantum=", 8) == 0)
+			{
+				config.quantum = strtoll(token + 8, NULL, 10);
+			}
+			else if (strncmp(token, "seed=", 5) == 0)
+			{
+				config.seed = strtoull(token + 5, NULL, 10);
+			}
+			else if (strncmp(token, "alpha=", 6) == 0)
+			{
+				config.predictAlpha = strtod(token + 6, NULL);
+			}
+			else if (strncmp(token, "initial=", 8) == 0)
+			{
+				config.predictInitial = strtoll(token + 8, NULL, 10);
+			}
+			else if (strncmp(token, "min=", 4) == 0)
+			{
+				config.adaptiveMin = strtoll(token + 4, NULL, 10);
+			}
+			else if (strncmp(token, "max=", 4) == 0)
+			{
+				config.adaptiveMax = strtoll(token + 4, NULL, 10);
+			}
+			else if (strncmp(token, "latency=", 8) == 0)
+			{
+				config.adaptiveLatency = strtoll(token + 8, NULL, 10);
+			}
+			else if (strncmp(token, "queue=", 6) == 0)
+			{
+				config.queueCapacity = atoi(token + 6);
+			}
+			else if (strncmp(token, "admission=", 10) == 0)
+			{
+				snprintf(shedding, sizeof(shedding), "%s", token + 10);
+				config.admission = shedding;
+			}
+			else if (strncmp(token, "tick=", 5) == 0)
+			{
+				config.tickPeriod = strtoll(token + 5, NULL, 10);
+			}
+			else if (strncmp(token, "cost=", 5) == 0)
+			{
+				config.tickCost = strtoll(token + 5, NULL, 10);
+			}
+			else if (strncmp(token, "tickless=", 9) == 0)
+			{
+				config.ticklessIdle = atoi(token + 9);
+			}
+			else if (strncmp(token, "jobs=", 5) == 0)
+			{
+				detail = atoi(token + 5);
+			}
+			else
+			{
+				error = "unknown request option";
+			}
+		} // end for
+
+		//Read jobs up to the end marker
+		int count = 0;
+		int ended = 0;
+		while (getline(&line, &length, in) != -1)
+		{
+			if (strncmp(line, "end", 3) == 0)
+			{
+				ended = 1;
+				break;
+			}
+
+			P5Job job = { 0, 0, 0 };
+			int consumed;
+			if (sscanf(line, "%" SCNd64 " %" SCNd64 "%n", &job.arrivalTime, &job.burstTime, &consumed) != 2)
+			{
+				continue;
+			}
+
+			char* weight = strstr(line + consumed, "weight=");
+			if (weight != NULL)
+			{
+				job.weight = atoi(weight + 7);
+			}
+			char* task = strstr(line + consumed, "task=");
+			if (task != NULL)
+			{
+				job.task = atoi(task + 5);
+			}
+			char* deadline = strstr(line + consumed, "deadline=");
+			if (deadline != NULL)
+			{
+				job.deadline = strtoll(deadline + 9, NULL, 10);
+			}
+
+			if (count == *capacity)
+			{
+				*capacity = *capacity ? *capacity * 2 : MAX_PROCESSES;
+				*jobs = realloc(*jobs, sizeof(P5Job) * (*capacity));
+			}
+			(*jobs)[count++] = job;
+		} // end while
+
+		//A request cut off part way is dropped along with the connection
+		if (!ended)
+		{
+			break;
+		}
+
+		//Simulate and stream the answer back
+		P5Result result;
+		int code = error ? P5_EWORKLOAD : p5_simulate(*jobs, count, &config, &result);
+		if (code != P5_OK)
+		{
+			fprintf(out, "error %s\nend\n", error ? error : p5_strerror(code));
+		}
+		else
+		{
+			int shed = 0;
+			int i;
+			for (i = 0; i < result.count; i++)
+			{
+				shed += result.jobs[i].shed;
+			}
+			fprintf(out, "ok count=%d response=%.2f turnaround=%.2f wait=%.2f makespan=%" PRId64 " shed=%d\n",
+					result.count, result.responseTime, result.turnTime, result.waitTime, result.makespan, shed);
+
+			for (i = 0; detail && i < result.count; i++)
+			{
+				P5JobResult* job = &result.jobs[i];
+				fprintf(out, "job %d %" PRId64 " %" PRId64 " %" PRId64 " %" PRId64 " %" PRId64 " %d\n",
+						i, job->startTime, job->endTime, job->responseTime, job->turnTime, job->waitTime, job->shed);
+			}
+			fprintf(out, "end\n");
+
+			p5_result_free(&result);
+		}
+
+		if (fflush(out) != 0)
+		{
+			break;
+		}
+	} // end while
+
+	free(line);
+	fclose(in);
+	fclose(out);
+} // end function serve_connection()
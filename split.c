@@ -0,0 +1,233 @@
+// ******************************************************************************************************************
+//  CPU Scheduler
+//  Copyright(C) 2018  James LoForti
+//  Contact Info: jamesloforti@gmail.com
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.If not, see<https://www.gnu.org/licenses/>.
+//									     ____.           .____             _____  _______   
+//									    |    |           |    |    ____   /  |  | \   _  \  
+//									    |    |   ______  |    |   /  _ \ /   |  |_/  /_\  \ 
+//									/\__|    |  /_____/  |    |__(  <_> )    ^   /\  \_/   \
+//									\________|           |_______ \____/\____   |  \_____  /
+//									                             \/          |__|        \/ 
+//
+// ******************************************************************************************************************
+//
+
+//Split runs: one cpu's schedule starts over whenever it goes idle, so a workload falls
+//apart into busy periods that can be simulated on their own. A period ends once every job
+//that arrived before it has finished, and that point is the same under any policy that
+//never idles with work waiting. Consecutive periods are grouped into spans of a few
+//thousand jobs, or enough to give every worker several, and the spans run on a thread
+//pool, each worker loading its span as a workload of its own. The main thread runs the
+//last span itself, the one the clock ends in, then puts every span's rows back in place
+//before the metrics are summed, so the report is the one a single run would print. Only
+//policies that carry nothing across an idle gap can be split: lottery's random stream,
+//stride's passes and the groups' quota periods run on through it
+
+#include <stdlib.h> 
+#include <stdio.h> // needed for perror()
+#include <string.h> // needed for strcmp()
+#include <pthread.h> // needed for the worker pool
+#include "p5.h"
+
+//Split globals, shared by the workers
+ProcessTable splitRows; // the whole workload, each span's rows written back as it finishes
+int* splitFirst; // first pid of each span, and the job count after the last
+int splitSpans;
+int nextSpan;
+pthread_mutex_t splitLock = PTHREAD_MUTEX_INITIALIZER;
+pthread_t* splitThreads;
+int splitThreadCount;
+Policy* splitPolicy;
+int splitJobs;
+
+//The one setting from the command line the split policies read, from the main thread's globals
+SimTime splitQuantum;
+
+PER_THREAD int splitPending; // the other spans are still to be gathered, in the main thread
+
+char* splitPolicies[] = { "fcfs", "sjf", "srtf", "rr", "psjf", "psrtf", NULL };
+
+int splits_at_idle(char* name)
+{
+	int i;
+	for (i = 0; splitPolicies[i] != NULL; i++)
+	{
+		if (!strcmp(splitPolicies[i], name))
+		{
+			return 1;
+		}
+	}
+	return 0;
+} // end function splits_at_idle()
+
+int find_spans(int workers)
+{
+	//Spans of at least a few thousand jobs, so loading one costs little next to running it
+	int target = numProcesses / (workers * SPLIT_SPANS);
+	target = (target > SPLIT_MIN_JOBS) ? target : SPLIT_MIN_JOBS;
+	splitFirst = malloc(sizeof(int) * ((numProcesses / target) + 2));
+	splitSpans = 0;
+
+	//Walk the arrivals, tracking when the cpu would go idle
+	int first = 0;
+	int queued = 0; // the job before arrived while another was running
+	SimTime busyUntil = processes.arrivalTime[0];
+	int i;
+	for (i = 0; i < numProcesses; i++)
+	{
+		//The event loops lose their place on a job with no burst, past any idle gap, so
+		//such a workload runs whole
+		if (!processes.burstTime[i])
+		{
+			splitFirst[0] = 0;
+			splitFirst[1] = numProcesses;
+			return 1;
+		}
+
+		//A job that arrives to an idle cpu starts a busy period, and maybe a new span. The
+		//policies start a run with its first job, where from idle they'd choose among all
+		//that arrive together, so it has to arrive alone. And they wind a run up with its
+		//last job already queued, so the one before has to have arrived to a busy cpu
+		int alone = (i + 1 == numProcesses || processes.arrivalTime[i + 1] != processes.arrivalTime[i]);
+		if (processes.arrivalTime[i] > busyUntil && alone && queued && i - first >= target)
+		{
+			splitFirst[splitSpans++] = first;
+			first = i;
+		}
+
+		queued = (processes.arrivalTime[i] < busyUntil);
+		busyUntil = (processes.arrivalTime[i] > busyUntil) ? processes.arrivalTime[i] : busyUntil;
+		busyUntil += processes.burstTime[i];
+	} // end for
+	splitFirst[splitSpans++] = first;
+	splitFirst[splitSpans] = numProcesses;
+
+	return splitSpans;
+} // end function find_spans()
+
+void run_split(Policy* policy, int workers)
+{
+	//One span is just a run. So is a bounded run queue: the jobs it sheds end a span in
+	//places the policies' last steps don't expect
+	if (!numProcesses || queueCapacity > 0 || find_spans(workers) < 2)
+	{
+		free(splitFirst);
+		splitFirst = NULL;
+		policy->run();
+		return;
+	}
+
+	//Hand the command line settings over to the workers
+	splitQuantum = quantum;
+	splitPolicy = policy;
+	splitRows = processes;
+	splitJobs = numProcesses;
+	nextSpan = 0;
+
+	//Workers take every span but the last
+	splitThreadCount = (workers - 1 < splitSpans - 1) ? (workers - 1) : (splitSpans - 1);
+	splitThreads = malloc(sizeof(pthread_t) * splitThreadCount);
+	int i;
+	for (i = 0; i < splitThreadCount; i++)
+	{
+		if (pthread_create(&splitThreads[i], NULL, split_worker, NULL) != 0)
+		{
+			perror("pthread_create");
+			exit(1);
+		}
+	} // end for
+
+	//The last span runs here, in a table of its own, and the report gathers the rest
+	ProcessTable empty = { 0 };
+	processes = empty;
+	load_span(splitSpans - 1);
+	init_all();
+	splitPending = 1;
+	policy->run();
+} // end function run_split()
+
+void* split_worker(void* unused)
+{
+	//Take on the command line settings, quietly
+	quantum = splitQuantum;
+	quiet = 1;
+
+	for (;;)
+	{
+		//Claim the next span
+		pthread_mutex_lock(&splitLock);
+		int span = nextSpan++;
+		pthread_mutex_unlock(&splitLock);
+		if (span >= splitSpans - 1)
+		{
+			break;
+		}
+
+		//Run it, and write its rows back where they came from; no two spans share a row
+		load_span(span);
+		init_all();
+		splitPolicy->run();
+		table_copy_rows(&splitRows, splitFirst[span], &processes, 0, numProcesses);
+	} // end for
+
+	table_destructor(&processes);
+	free(pendingSJF);
+	pendingSJF = NULL;
+	return unused;
+} // end function split_worker()
+
+void load_span(int span)
+{
+	int first = splitFirst[span];
+	int count = splitFirst[span + 1] - first;
+
+	//Room for the span and the zeroed row past it, like a workload read in
+	if (count + 1 > processes.capacity)
+	{
+		table_reserve(&processes, count + 1);
+		pendingSJF = realloc(pendingSJF, sizeof(int) * processes.capacity);
+	}
+
+	table_copy_rows(&processes, 0, &splitRows, first, count);
+#define CLEAR_COLUMN(type, name) \
+	memset(&processes.name[count], 0, sizeof(type));
+	PROCESS_COLUMNS(CLEAR_COLUMN)
+#undef CLEAR_COLUMN
+	numProcesses = count;
+} // end function load_span()
+
+void gather_spans()
+{
+	splitPending = 0;
+	int i;
+	for (i = 0; i < splitThreadCount; i++)
+	{
+		pthread_join(splitThreads[i], NULL);
+	}
+
+	//Put the last span's rows in place, and take the whole table back up where it ended
+	int first = splitFirst[splitSpans - 1];
+	table_copy_rows(&splitRows, first, &processes, 0, numProcesses);
+	running += first;
+	table_destructor(&processes);
+	processes = splitRows;
+	numProcesses = splitJobs;
+	pendingSJF = realloc(pendingSJF, sizeof(int) * processes.capacity);
+
+	free(splitThreads);
+	free(splitFirst);
+	splitFirst = NULL;
+} // end function gather_spans()
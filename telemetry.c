@@ -0,0 +1,314 @@
+// ******************************************************************************************************************
+//  CPU Scheduler
+//  Copyright(C) 2018  James LoForti
+//  Contact Info: jamesloforti@gmail.com
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.If not, see<https://www.gnu.org/licenses/>.
+//									     ____.           .____             _____  _______   
+//									    |    |           |    |    ____   /  |  | \   _  \  
+//									    |    |   ______  |    |   /  _ \ /   |  |_/  /_\  \ 
+//									/\__|    |  /_____/  |    |__(  <_> )    ^   /\  \_/   \
+//									\________|           |_______ \____/\____   |  \_____  /
+//									                             \/          |__|        \/ 
+//
+// ******************************************************************************************************************
+//
+
+//Telemetry: windowed time series of a finished run, written as a compact columnar file.
+//Nothing is sampled inside the event loops. Every policy on one cpu keeps the cpu busy
+//whenever a job is in the system, except where the group policy holds everything back,
+//and those idle spans are the only thing the loop records. The rest comes from a single
+//sweep over the arrival and end times once the run is over. Layout, every integer a varint:
+//	file:	magic (4 bytes), policy name length and bytes, window length, first window start,
+//		unit in nanoseconds (0 for abstract units), window count, column count, columns...
+//	column:	name length and bytes, one value per window
+
+#include <stdlib.h> 
+#include <stdio.h> // needed for fopen()
+#include <string.h> // needed for strlen()
+#include <inttypes.h> // needed for PRId64
+#include "p5.h"
+
+//Telemetry globals
+PER_THREAD char* telemetryPath; // series are written to <path>.<policy>, NULL = off
+PER_THREAD SimTime telemetryWindow; // simulated time per window, 0 = auto
+PER_THREAD SimTime* idleSpans; // start, end pairs where the cpu idled with jobs waiting
+PER_THREAD int idleCount;
+PER_THREAD int idleCapacity;
+
+char* telemetryColumns[TELEMETRY_COLUMNS] =
+{
+	"arrivals", // jobs arriving in the window
+	"completions", // jobs finishing in the window
+	"shed", // jobs admission control turned away in the window
+	"busy", // time the cpu spent running jobs; utilization is busy over the window length
+	"depth_max", // most jobs waiting in the run queue at once
+	"depth_avg_milli", // jobs waiting in the run queue, averaged over time, in thousandths
+	"p50", // turnaround percentiles of the jobs finishing in the window, 0 if none
+	"p95",
+	"p99"
+};
+
+void telemetry_idle(SimTime from, SimTime to)
+{
+	if (telemetryPath == NULL || to <= from)
+	{
+		return;
+	}
+
+	if (idleCount + 2 > idleCapacity)
+	{
+		idleCapacity = idleCapacity ? idleCapacity * 2 : 64;
+		idleSpans = realloc(idleSpans, sizeof(SimTime) * idleCapacity);
+	}
+	idleSpans[idleCount++] = from;
+	idleSpans[idleCount++] = to;
+} // end function telemetry_idle()
+
+void write_telemetry(char* policyName)
+{
+	//Pids are in arrival order already, so only the ends need sorting
+	int* ends = malloc(sizeof(int) * (numProcesses + 1));
+	int i;
+	for (i = 0; i < numProcesses; i++)
+	{
+		ends[i] = i;
+	}
+	qsort(ends, numProcesses, sizeof(int), compare_end);
+
+	//Cut the run into windows, a hundred of them unless told otherwise
+	SimTime origin = processes.arrivalTime[0];
+	SimTime span = processes.endTime[ends[numProcesses - 1]] - origin;
+	SimTime window = telemetryWindow;
+	if (window <= 0)
+	{
+		window = span / TELEMETRY_WINDOWS;
+		window = (window > 0) ? window : 1;
+	}
+	int windows = (int)(span / window) + 1;
+
+	long long* columns = calloc((size_t)windows * TELEMETRY_COLUMNS, sizeof(long long));
+	SimTime* turnTimes = malloc(sizeof(SimTime) * (numProcesses + 1));
+
+	//Sweep the windows, stepping from event to event inside each one
+	int arrival = 0;
+	int end = 0;
+	int idle = 0; // index of the next idle span boundary
+	int inSystem = 0;
+	int w;
+	for (w = 0; w < windows; w++)
+	{
+		long long* row = &columns[(size_t)w * TELEMETRY_COLUMNS];
+		SimTime now = origin + (w * window);
+		SimTime windowEnd = now + window;
+		long double depthArea = 0;
+		int turnCount = 0;
+		int depth = inSystem - ((inSystem > 0 && !(idle & 1)) ? 1 : 0);
+		row[4] = depth;
+
+		while (now < windowEnd)
+		{
+			//Next event: an end, an arrival, an idle span boundary or the end of the window
+			SimTime next = windowEnd;
+			if (end < numProcesses && processes.endTime[ends[end]] < next)
+			{
+				next = processes.endTime[ends[end]];
+			}
+			if (arrival < numProcesses && processes.arrivalTime[arrival] < next)
+			{
+				next = processes.arrivalTime[arrival];
+			}
+			if (idle < idleCount && idleSpans[idle] < next)
+			{
+				next = idleSpans[idle];
+			}
+
+			//Integrate up to it: the cpu runs one job whenever any are in and it isn't held idle
+			int busy = (inSystem > 0 && !(idle & 1));
+			depth = inSystem - busy;
+			row[3] += busy ? (next - now) : 0;
+			depthArea += (long double)depth * (next - now);
+			now = next;
+
+			//Jobs leave before others arrive at the same instant
+			while (end < numProcesses && processes.endTime[ends[end]] == now && now < windowEnd)
+			{
+				int pid = ends[end++];
+				inSystem--;
+				if (processes.shed[pid])
+				{
+					row[2]++;
+				}
+				else
+				{
+					row[1]++;
+					turnTimes[turnCount++] = processes.endTime[pid] - processes.arrivalTime[pid];
+				}
+			} // end while
+			while (arrival < numProcesses && processes.arrivalTime[arrival] == now && now < windowEnd)
+			{
+				arrival++;
+				inSystem++;
+				row[0]++;
+			}
+			while (idle < idleCount && idleSpans[idle] == now && now < windowEnd)
+			{
+				idle++;
+			}
+
+			depth = inSystem - ((inSystem > 0 && !(idle & 1)) ? 1 : 0);
+			row[4] = (depth > row[4]) ? depth : row[4];
+		} // end while
+
+		row[5] = (long long)((depthArea * 1000) / window);
+
+		//Percentiles by nearest rank
+		if (turnCount)
+		{
+			qsort(turnTimes, turnCount, sizeof(SimTime), compare_times);
+			row[6] = turnTimes[(int)((((long long)turnCount * 50) + 99) / 100) - 1];
+			row[7] = turnTimes[(int)((((long long)turnCount * 95) + 99) / 100) - 1];
+			row[8] = turnTimes[(int)((((long long)turnCount * 99) + 99) / 100) - 1];
+		}
+	} // end for
+
+	//Write to <path>.<policy>
+	char path[4096];
+	snprintf(path, sizeof(path), "%s.%s", telemetryPath, policyName);
+	FILE* file = fopen(path, "wb");
+	if (file == NULL)
+	{
+		perror(path);
+		exit(1);
+	}
+
+	unsigned char buffer[VARINT_MAX];
+	fwrite(TELEMETRY_MAGIC, 1, 4, file);
+	fwrite(buffer, 1, put_varint(buffer, strlen(policyName)), file);
+	fwrite(policyName, 1, strlen(policyName), file);
+	fwrite(buffer, 1, put_varint(buffer, (uint64_t)window), file);
+	fwrite(buffer, 1, put_varint(buffer, (uint64_t)origin), file);
+	fwrite(buffer, 1, put_varint(buffer, (inputUnit != NULL) ? (uint64_t)inputUnit->nanoseconds : 0), file);
+	fwrite(buffer, 1, put_varint(buffer, windows), file);
+	fwrite(buffer, 1, put_varint(buffer, TELEMETRY_COLUMNS), file);
+
+	//A column at a time, so each one compresses and reads on its own
+	int c;
+	for (c = 0; c < TELEMETRY_COLUMNS; c++)
+	{
+		fwrite(buffer, 1, put_varint(buffer, strlen(telemetryColumns[c])), file);
+		fwrite(telemetryColumns[c], 1, strlen(telemetryColumns[c]), file);
+		for (w = 0; w < windows; w++)
+		{
+			fwrite(buffer, 1, put_varint(buffer, (uint64_t)columns[(size_t)w * TELEMETRY_COLUMNS + c]), file);
+		}
+	} // end for
+
+	if (fclose(file) != 0)
+	{
+		perror(path);
+		exit(1);
+	}
+
+	free(ends);
+	free(columns);
+	free(turnTimes);
+	idleCount = 0;
+} // end function write_telemetry()
+
+void print_telemetry(FILE* in)
+{
+	unsigned char magic[4];
+	if (fread(magic, 1, 4, in) != 4 || memcmp(magic, TELEMETRY_MAGIC, 4) != 0)
+	{
+		fprintf(stderr, "not a telemetry file\n");
+		exit(1);
+	}
+
+	//Header
+	char name[256];
+	uint64_t length = read_varint(in);
+	if (length >= sizeof(name) || fread(name, 1, length, in) != length)
+	{
+		fprintf(stderr, "corrupt telemetry file\n");
+		exit(1);
+	}
+	name[length] = '\0';
+	SimTime window = (SimTime)read_varint(in);
+	SimTime origin = (SimTime)read_varint(in);
+	uint64_t unit = read_varint(in);
+	int windows = (int)read_varint(in);
+	int columnCount = (int)read_varint(in);
+
+	//Pull every column in, then print them side by side
+	char (*names)[64] = malloc(sizeof(*names) * columnCount);
+	long long* columns = malloc(sizeof(long long) * (size_t)windows * columnCount);
+	int c, w;
+	for (c = 0; c < columnCount; c++)
+	{
+		length = read_varint(in);
+		if (length >= sizeof(names[c]) || fread(names[c], 1, length, in) != length)
+		{
+			fprintf(stderr, "corrupt telemetry file\n");
+			exit(1);
+		}
+		names[c][length] = '\0';
+
+		for (w = 0; w < windows; w++)
+		{
+			columns[(size_t)c * windows + w] = (long long)read_varint(in);
+		}
+	} // end for
+
+	//Workloads in abstract units have no unit to report
+	printf("#%s, windows of %" PRId64 " from %" PRId64, name, window, origin);
+	if (unit)
+	{
+		printf(", unit %" PRIu64 "ns\n", unit);
+	}
+	else
+	{
+		printf(", unit none\n");
+	}
+	printf("time");
+	for (c = 0; c < columnCount; c++)
+	{
+		printf("\t%s", names[c]);
+	}
+	printf("\n");
+	for (w = 0; w < windows; w++)
+	{
+		printf("%" PRId64, origin + (w * window));
+		for (c = 0; c < columnCount; c++)
+		{
+			printf("\t%lld", columns[(size_t)c * windows + w]);
+		}
+		printf("\n");
+	} // end for
+
+	free(names);
+	free(columns);
+} // end function print_telemetry()
+
+int compare_end(const void* a, const void* b)
+{
+	int left = *(const int*)a;
+	int right = *(const int*)b;
+
+	if (processes.endTime[left] != processes.endTime[right])
+	{
+		return (processes.endTime[left] < processes.endTime[right]) ? -1 : 1;
+	}
+	return left - right;
+} // end function compare_end()
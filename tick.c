@@ -0,0 +1,390 @@
+// ******************************************************************************************************************
+//  CPU Scheduler
+//  Copyright(C) 2018  James LoForti
+//  Contact Info: jamesloforti@gmail.com
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.If not, see<https://www.gnu.org/licenses/>.
+//									     ____.           .____             _____  _______   
+//									    |    |           |    |    ____   /  |  | \   _  \  
+//									    |    |   ______  |    |   /  _ \ /   |  |_/  /_\  \ 
+//									/\__|    |  /_____/  |    |__(  <_> )    ^   /\  \_/   \
+//									\________|           |_______ \____/\____   |  \_____  /
+//									                             \/          |__|        \/ 
+//
+// ******************************************************************************************************************
+//
+//Tick driven runs: srtf and rr the way a kernel with a periodic timer runs them. A
+//preemption waits for the next tick, and every tick holds the cpu in its handler for a
+//fixed cost before the runner gets it back. With periodic idle the tick keeps firing on an
+//idle cpu, and a job waking up inside the handler waits for it; tickless idle stops the
+//tick while nothing is runnable. A job still starts the moment the cpu frees up, on
+//arriving to an idle cpu or when the runner finishes. Between the events that can change
+//the schedule (an arrival, a completion, the tick a slice ends or a preemption is due at)
+//the clock moves in one step, charging the ticks in between in closed form, so a short
+//tick costs no more to simulate than a long one
+
+#include <stdlib.h> 
+#include <stdio.h> // needed for printf()
+#include <string.h> // needed for strcmp()
+#include <inttypes.h> // needed for PRId64
+#include "p5.h"
+
+//Tick globals
+PER_THREAD SimTime tickPeriod; // 0 runs the event driven loops
+PER_THREAD SimTime tickCost; // cpu time each tick spends in its handler
+PER_THREAD int tickHz; // the period given as a rate, resolved once the workload's unit is known
+PER_THREAD int ticklessIdle; // stop the tick while the cpu is idle
+PER_THREAD SimTime handlerUntil; // the tick handler holds the cpu until then
+PER_THREAD SimTime lastTick; // latest tick accounted for
+PER_THREAD long long busyTicks;
+PER_THREAD long long idleTicks;
+PER_THREAD int* tickQueue; // rr run queue, a ring of pids
+PER_THREAD int tickQueueHead;
+PER_THREAD int tickQueueCount;
+
+int parse_tick(char* text)
+{
+	//period or rate, then optionally the cost and the idle mode: 1000:5 or 250hz:20000:tickless
+	long long period = 0;
+	long long cost = 0;
+	int consumed = 0;
+	if (sscanf(text, "%lld%n", &period, &consumed) != 1 || period < 1)
+	{
+		return 0;
+	}
+	text += consumed;
+
+	tickHz = 0;
+	if (strncmp(text, "hz", 2) == 0)
+	{
+		if (period > 1000000000)
+		{
+			return 0;
+		}
+		tickHz = (int)period;
+		text += 2;
+	}
+
+	if (*text == ':')
+	{
+		if (sscanf(text + 1, "%lld%n", &cost, &consumed) != 1 || cost < 0)
+		{
+			return 0;
+		}
+		text += 1 + consumed;
+	}
+
+	ticklessIdle = 0;
+	if (*text == ':')
+	{
+		text++;
+		if (strcmp(text, "tickless") == 0)
+		{
+			ticklessIdle = 1;
+		}
+		else if (strcmp(text, "periodic") != 0)
+		{
+			return 0;
+		}
+		text += strlen(text);
+	}
+
+	//The handler has to leave the runner some of every tick
+	if (*text || (!tickHz && cost >= period))
+	{
+		return 0;
+	}
+
+	tickPeriod = tickHz ? 0 : (SimTime)period;
+	tickCost = (SimTime)cost;
+	return 1;
+} // end function parse_tick()
+
+int resolve_tick()
+{
+	//A rate becomes a period in the workload's own unit
+	if (tickHz)
+	{
+		if (inputUnit == NULL)
+		{
+			return 0;
+		}
+		tickPeriod = (1000000000 / inputUnit->nanoseconds) / tickHz;
+	}
+
+	return tickPeriod > tickCost;
+} // end function resolve_tick()
+
+int ticks_supported(char* name)
+{
+	return !strcmp(name, "srtf") || !strcmp(name, "rr");
+} // end function ticks_supported()
+
+void run_ticked(Policy* policy)
+{
+	//The stride heap orders on pass, so pass holds srtf's remaining burst here; rr queues in a ring
+	int preemptive = !strcmp(policy->name, "srtf");
+	reserve_share(numProcesses);
+	tickQueue = realloc(tickQueue, sizeof(int) * numProcesses);
+	tickQueueHead = 0;
+	tickQueueCount = 0;
+	heapCount = 0;
+
+	int i;
+	for (i = 0; i < numProcesses; i++)
+	{
+		remainingBurst[i] = processes.burstTime[i];
+	}
+
+	//The tick before the first arrival may still be in its handler
+	simClock = processes.arrivalTime[0];
+	lastTick = tick_floor(simClock) - tickPeriod;
+	handlerUntil = simClock;
+	busyTicks = 0;
+	idleTicks = 0;
+	running = -1;
+	SimTime sliceUsed = 0;
+	int nextArrival = 0;
+	int finished = 0;
+	while (finished < numProcesses)
+	{
+		//Arrivals join the run queue the moment they come
+		while (nextArrival < numProcesses && processes.arrivalTime[nextArrival] <= simClock)
+		{
+			processes.beginWaiting[nextArrival] = simClock;
+			enqueue_ticked(nextArrival++, preemptive);
+		}
+
+		//A tick due now: its handler takes the cpu, then the runner may be preempted
+		int queued = preemptive ? heapCount : tickQueueCount;
+		if (simClock > lastTick && tick_floor(simClock) == simClock)
+		{
+			lastTick = simClock;
+			if (running >= 0 || queued || !ticklessIdle)
+			{
+				busyTicks += (running >= 0 || queued);
+				idleTicks += (running < 0 && !queued);
+				handlerUntil = simClock + tickCost;
+			}
+
+			if (running >= 0 && preemptive && queued && pass[strideHeap[0]] <= remainingBurst[running])
+			{
+				processes.beginWaiting[running] = simClock;
+				enqueue_ticked(running, preemptive);
+				running = -1;
+			}
+			else if (running >= 0 && !preemptive && sliceUsed >= quantum)
+			{
+				//The slice is used up: to the back of the line, or a fresh slice if it's alone
+				if (queued)
+				{
+					processes.beginWaiting[running] = simClock;
+					enqueue_ticked(running, preemptive);
+					running = -1;
+				}
+				sliceUsed = 0;
+			}
+		} // end if
+
+		//A free cpu takes the next job as soon as the handler lets go of it
+		if (running < 0 && (preemptive ? heapCount : tickQueueCount))
+		{
+			running = dequeue_ticked(preemptive);
+			SimTime begin = (handlerUntil > simClock) ? handlerUntil : simClock;
+			processes.waitTime[running] += begin - processes.beginWaiting[running];
+			if (!processes.started[running])
+			{
+				processes.startTime[running] = begin;
+				processes.started[running] = 1;
+			}
+			sliceUsed = 0;
+			contextSwitches++;
+		}
+
+		//Nothing runnable: idle until the next arrival
+		if (running < 0)
+		{
+			idle_ticked(processes.arrivalTime[nextArrival]);
+			continue;
+		}
+
+		//Run to the next event: an arrival, the runner finishing, or the tick that may preempt it
+		SimTime next = tick_finish(simClock, remainingBurst[running]);
+		if (nextArrival < numProcesses && processes.arrivalTime[nextArrival] < next)
+		{
+			next = processes.arrivalTime[nextArrival];
+		}
+		SimTime due = preemption_tick(preemptive, sliceUsed, nextArrival < numProcesses);
+		next = (due < next) ? due : next;
+
+		SimTime ran = tick_work(simClock, next);
+		remainingBurst[running] -= ran;
+		sliceUsed += ran;
+		pass_ticks(next, 1);
+		simClock = next;
+
+		//If the runner is finished
+		if (!remainingBurst[running])
+		{
+			processes.endTime[running] = simClock;
+			running = -1;
+			finished++;
+		}
+	} // end while
+
+	//Calculate avg times and print to console, then what the tick cost
+	char label[128];
+	if (preemptive)
+	{
+		snprintf(label, sizeof(label), "Shortest Remaining Time First (tick %" PRId64 ", cost %" PRId64 "%s)",
+				tickPeriod, tickCost, ticklessIdle ? ", tickless idle" : "");
+	}
+	else
+	{
+		snprintf(label, sizeof(label), "Round Robin (w/ quantum %" PRId64 ", tick %" PRId64 ", cost %" PRId64 "%s)",
+				quantum, tickPeriod, tickCost, ticklessIdle ? ", tickless idle" : "");
+	}
+	calc_times_and_print(label);
+
+	if (!quiet)
+	{
+		print_ticks();
+	}
+} // end function run_ticked()
+
+void enqueue_ticked(int pid, int preemptive)
+{
+	if (preemptive)
+	{
+		pass[pid] = remainingBurst[pid];
+		heap_push(pid);
+	}
+	else
+	{
+		tickQueue[(tickQueueHead + tickQueueCount++) % numProcesses] = pid;
+	}
+} // end function enqueue_ticked()
+
+int dequeue_ticked(int preemptive)
+{
+	if (preemptive)
+	{
+		return heap_pop();
+	}
+
+	int pid = tickQueue[tickQueueHead];
+	tickQueueHead = (tickQueueHead + 1) % numProcesses;
+	tickQueueCount--;
+	return pid;
+} // end function dequeue_ticked()
+
+SimTime preemption_tick(int preemptive, SimTime sliceUsed, int arrivalsLeft)
+{
+	//srtf preempts at the next tick if the best waiting job needs no more than the runner
+	SimTime nextTick = tick_floor(simClock) + tickPeriod;
+	if (preemptive)
+	{
+		return (heapCount && pass[strideHeap[0]] <= remainingBurst[running]) ? nextTick : INT64_MAX;
+	}
+
+	//rr at the first tick after its slice is used up. A runner on its own gets a fresh slice
+	//there instead, which only matters while someone may still arrive to wait behind it
+	if (!tickQueueCount && !arrivalsLeft)
+	{
+		return INT64_MAX;
+	}
+	if (sliceUsed >= quantum)
+	{
+		return nextTick;
+	}
+	SimTime used = tick_finish(simClock, quantum - sliceUsed);
+	return (tick_floor(used) == used) ? used : (tick_floor(used) + tickPeriod);
+} // end function preemption_tick()
+
+SimTime tick_finish(SimTime from, SimTime work)
+{
+	//Up to the next tick the runner has the cpu once the handler is done
+	SimTime begin = (handlerUntil > from) ? handlerUntil : from;
+	SimTime nextTick = tick_floor(from) + tickPeriod;
+	if (work <= nextTick - begin)
+	{
+		return begin + work;
+	}
+
+	//Past it, every tick gives the runner all but the handler's cost
+	work -= nextTick - begin;
+	SimTime share = tickPeriod - tickCost;
+	SimTime ticks = (work - 1) / share;
+	return nextTick + (ticks * tickPeriod) + tickCost + (work - (ticks * share));
+} // end function tick_finish()
+
+SimTime tick_work(SimTime from, SimTime to)
+{
+	//What the runner gets done between two times, the inverse of tick_finish()
+	SimTime begin = (handlerUntil > from) ? handlerUntil : from;
+	SimTime nextTick = tick_floor(from) + tickPeriod;
+	if (to <= nextTick)
+	{
+		return (to > begin) ? (to - begin) : 0;
+	}
+
+	SimTime past = to - nextTick;
+	SimTime partial = (past % tickPeriod) - tickCost;
+	return (nextTick - begin) + ((past / tickPeriod) * (tickPeriod - tickCost)) + ((partial > 0) ? partial : 0);
+} // end function tick_work()
+
+void pass_ticks(SimTime to, int busy)
+{
+	//Account for the ticks strictly between now and then; one landing right on it is handled there
+	SimTime last = tick_floor(to - 1);
+	long long count = (last - tick_floor(simClock)) / tickPeriod;
+	if (count <= 0)
+	{
+		return;
+	}
+
+	lastTick = last;
+	if (busy || !ticklessIdle)
+	{
+		busyTicks += busy ? count : 0;
+		idleTicks += busy ? 0 : count;
+		handlerUntil = last + tickCost;
+	}
+} // end function pass_ticks()
+
+void idle_ticked(SimTime to)
+{
+	telemetry_idle(simClock, to);
+	pass_ticks(to, 0);
+	simClock = to;
+} // end function idle_ticked()
+
+SimTime tick_floor(SimTime time)
+{
+	//The latest tick at or before a time, with ticks on every multiple of the period
+	return time - (((time % tickPeriod) + tickPeriod) % tickPeriod);
+} // end function tick_floor()
+
+void print_ticks()
+{
+	//Label times with their unit, when the workload declared one
+	char* unit = (outputUnit != NULL) ? outputUnit->name : "";
+	char* space = (outputUnit != NULL) ? " " : "";
+	SimTime span = simClock - processes.arrivalTime[0];
+	double handler = (double)(busyTicks + idleTicks) * tickCost;
+
+	printf("\tTicks: %lld busy, %lld idle, %.2f%s%s in the handler (%.2f%% of the run)\n", busyTicks, idleTicks,
+			to_output_unit(handler), space, unit, span ? (100.0 * handler / span) : 0);
+	printf("\tContext Switches: %d\n", contextSwitches);
+} // end function print_ticks()
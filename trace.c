@@ -0,0 +1,415 @@
+// ******************************************************************************************************************
+//  CPU Scheduler
+//  Copyright(C) 2018  James LoForti
+//  Contact Info: jamesloforti@gmail.com
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.If not, see<https://www.gnu.org/licenses/>.
+//									     ____.           .____             _____  _______   
+//									    |    |           |    |    ____   /  |  | \   _  \  
+//									    |    |   ______  |    |   /  _ \ /   |  |_/  /_\  \ 
+//									/\__|    |  /_____/  |    |__(  <_> )    ^   /\  \_/   \
+//									\________|           |_______ \____/\____   |  \_____  /
+//									                             \/          |__|        \/ 
+//
+// ******************************************************************************************************************
+//
+
+//Trace importers: rebuild a workload from the kernel's own scheduling decisions, as
+//captured by "perf sched record; perf sched script" or by ftrace's sched_switch and
+//sched_wakeup events. Each wakeup-to-block cycle of a task becomes one job whose burst
+//is the cpu time it got in that cycle. The trace is streamed a line at a time and a task is
+//forgotten once it switches out dead, so memory is bounded by the job table and the tasks
+//alive at once, not the trace size.
+
+#include <stdlib.h> 
+#include <stdio.h> // needed for getline()
+#include <string.h> // needed for strstr()
+#include <ctype.h> // needed for isdigit()
+#include "p5.h"
+
+//Task globals
+PER_THREAD Task* tasks; // open addressed on pid
+PER_THREAD int taskCapacity;
+PER_THREAD int taskCount;
+PER_THREAD int traceCpu; // only replay this cpu, -1 for all
+PER_THREAD Summary observed; // what the kernel actually did
+PER_THREAD int observedJobs;
+PER_THREAD long double observedSums[3];
+PER_THREAD SimTime traceEnd; // latest timestamp seen
+
+void read_trace(int cpu)
+{
+	traceCpu = cpu;
+	traceEnd = 0;
+	observedJobs = 0;
+	memset(observedSums, 0, sizeof(observedSums));
+
+	//Timestamps are converted to integer nanoseconds
+	inputUnit = find_unit("ns");
+
+	//For every line of the trace
+	char* line = NULL;
+	size_t length = 0;
+	while (getline(&line, &length, stdin) != -1)
+	{
+		char* event;
+		if ((event = strstr(line, "sched_switch:")) != NULL)
+		{
+			trace_switch(line, event, event + 13);
+		}
+		else if ((event = strstr(line, "sched_wakeup_new:")) != NULL)
+		{
+			trace_wakeup(line, event, event + 17);
+		}
+		else if ((event = strstr(line, "sched_wakeup:")) != NULL)
+		{
+			trace_wakeup(line, event, event + 13);
+		}
+	} // end while
+	free(line);
+
+	//Tasks still on a cpu when the capture ended become truncated jobs
+	int i;
+	for (i = 0; i < taskCapacity; i++)
+	{
+		if (tasks[i].pid > 0 && tasks[i].runnable)
+		{
+			if (tasks[i].switchedIn >= 0)
+			{
+				tasks[i].burst += (traceEnd - tasks[i].switchedIn);
+			}
+			emit_job(&tasks[i], traceEnd);
+		}
+	} // end for
+
+	free(tasks);
+	tasks = NULL;
+	taskCapacity = 0;
+	taskCount = 0;
+
+	//The kernel finished jobs in its own order, the simulator wants them by arrival
+	sort_processes_by_arrival();
+
+	//Average what the kernel did
+	if (observedJobs)
+	{
+		observed.responseTime = (double)(observedSums[0] / observedJobs);
+		observed.turnTime = (double)(observedSums[1] / observedJobs);
+		observed.waitTime = (double)(observedSums[2] / observedJobs);
+	}
+
+	finish_workload();
+} // end function read_trace()
+
+void trace_switch(char* line, char* event, char* fields)
+{
+	SimTime time;
+	int cpu;
+	if (!parse_trace_header(line, event, &time, &cpu) || (traceCpu >= 0 && cpu != traceCpu))
+	{
+		return;
+	}
+
+	int prevPid, nextPid;
+	char prevState;
+	char* arrow = strstr(fields, "==>");
+	if (arrow == NULL)
+	{
+		return;
+	}
+
+	//ftrace and older perf print key=value pairs, newer perf prints "comm:pid [prio] state ==> comm:pid [prio]"
+	char* value;
+	if ((value = strstr(fields, "prev_pid=")) != NULL)
+	{
+		prevPid = atoi(value + 9);
+		value = strstr(fields, "prev_state=");
+		prevState = (value != NULL) ? value[11] : 'S';
+		value = strstr(arrow, "next_pid=");
+		nextPid = (value != NULL) ? atoi(value + 9) : 0;
+	}
+	else
+	{
+		//Walk back from the arrow to the state letter, and to the last colon for the pid
+		char* state = arrow - 1;
+		while (state > fields && isspace((unsigned char)*state))
+		{
+			state--;
+		}
+		while (state > fields && !isspace((unsigned char)state[-1]))
+		{
+			state--;
+		}
+		prevState = *state;
+		prevPid = trace_compact_pid(fields, state);
+		nextPid = trace_compact_pid(arrow + 3, arrow + strlen(arrow));
+	}
+
+	//The task coming off the cpu banks its run time, and its job ends if it blocked
+	Task* prev = find_task(prevPid);
+	if (prev != NULL && prev->switchedIn >= 0)
+	{
+		prev->burst += (time - prev->switchedIn);
+		prev->switchedIn = -1;
+
+		if (prevState != 'R')
+		{
+			emit_job(prev, time);
+		}
+	}
+
+	//A task that exited won't be seen again, and a reused pid starts afresh
+	if (prev != NULL && (prevState == 'X' || prevState == 'Z'))
+	{
+		remove_task(prev);
+	}
+
+	//The task going on the cpu opens a job if the trace never saw it wake up
+	Task* next = find_task(nextPid);
+	if (next != NULL)
+	{
+		if (!next->runnable)
+		{
+			open_job(next, time);
+		}
+		if (next->firstRun < 0)
+		{
+			next->firstRun = time;
+		}
+		next->switchedIn = time;
+	}
+} // end function trace_switch()
+
+void trace_wakeup(char* line, char* event, char* fields)
+{
+	SimTime time;
+	int cpu;
+	if (!parse_trace_header(line, event, &time, &cpu))
+	{
+		return;
+	}
+
+	//A wakeup aimed at another cpu doesn't concern a single cpu replay
+	char* value = strstr(fields, "target_cpu=");
+	if (traceCpu >= 0 && value != NULL && atoi(value + 11) != traceCpu)
+	{
+		return;
+	}
+
+	//" pid=" in ftrace and older perf, "comm:pid [prio]" in newer perf
+	int pid;
+	if ((value = strstr(fields, " pid=")) != NULL)
+	{
+		pid = atoi(value + 5);
+	}
+	else
+	{
+		while (isspace((unsigned char)*fields))
+		{
+			fields++;
+		}
+		char* end = fields;
+		while (*end && !isspace((unsigned char)*end))
+		{
+			end++;
+		}
+		pid = trace_compact_pid(fields, end);
+	}
+
+	//Waking a task that is already runnable doesn't start a new job
+	Task* task = find_task(pid);
+	if (task != NULL && !task->runnable)
+	{
+		open_job(task, time);
+	}
+} // end function trace_wakeup()
+
+int parse_trace_header(char* line, char* event, SimTime* time, int* cpu)
+{
+	//The event name may carry a "sched:" prefix, step back to the start of its token
+	while (event > line && !isspace((unsigned char)event[-1]))
+	{
+		event--;
+	}
+
+	//The timestamp is the last "seconds.fraction:" token before the event
+	char* colon = event;
+	while (colon > line && *colon != ':')
+	{
+		colon--;
+	}
+	char* start = colon;
+	while (start > line && (isdigit((unsigned char)start[-1]) || start[-1] == '.'))
+	{
+		start--;
+	}
+	if (start == colon)
+	{
+		return 0;
+	}
+
+	SimTime seconds = 0;
+	SimTime fraction = 0;
+	int digits = 0;
+	char* c;
+	for (c = start; *c != '.' && c < colon; c++)
+	{
+		seconds = (seconds * 10) + (*c - '0');
+	}
+	for (c++; c < colon && digits < 9; c++, digits++)
+	{
+		fraction = (fraction * 10) + (*c - '0');
+	}
+	for (; digits < 9; digits++)
+	{
+		fraction *= 10;
+	}
+	*time = (seconds * 1000000000LL) + fraction;
+
+	//The cpu is the bracketed number before the timestamp
+	char* bracket = start;
+	while (bracket > line && *bracket != '[')
+	{
+		bracket--;
+	}
+	*cpu = (*bracket == '[') ? atoi(bracket + 1) : -1;
+
+	traceEnd = (*time > traceEnd) ? *time : traceEnd;
+	return 1;
+} // end function parse_trace_header()
+
+int trace_compact_pid(char* start, char* end)
+{
+	//"comm:pid", where comm may itself hold colons
+	char* colon = NULL;
+	char* c;
+	for (c = start; c < end && *c != '\0' && *c != '['; c++)
+	{
+		if (*c == ':')
+		{
+			colon = c;
+		}
+	}
+
+	return (colon != NULL) ? atoi(colon + 1) : 0;
+} // end function trace_compact_pid()
+
+Task* find_task(int pid)
+{
+	//The idle task isn't a workload
+	if (pid <= 0)
+	{
+		return NULL;
+	}
+
+	//Keep the table at most half full
+	if ((taskCount + 1) * 2 > taskCapacity)
+	{
+		grow_tasks();
+	}
+
+	//Linear probe from the pid's home slot
+	int slot = (int)(((unsigned)pid * 2654435761u) & (unsigned)(taskCapacity - 1));
+	while (tasks[slot].pid != 0 && tasks[slot].pid != pid)
+	{
+		slot = (slot + 1) & (taskCapacity - 1);
+	}
+
+	//New task, not runnable and not on a cpu yet. A slot freed by an exit may hold old values
+	if (tasks[slot].pid == 0)
+	{
+		memset(&tasks[slot], 0, sizeof(Task));
+		tasks[slot].pid = pid;
+		tasks[slot].runnable = 0;
+		tasks[slot].switchedIn = -1;
+		taskCount++;
+	}
+
+	return &tasks[slot];
+} // end function find_task()
+
+void remove_task(Task* task)
+{
+	//Pull later tasks of the same probe run back into the hole, so no lookup stops short
+	int hole = (int)(task - tasks);
+	int slot = hole;
+	while (tasks[slot = (slot + 1) & (taskCapacity - 1)].pid != 0)
+	{
+		//A task can move back as long as the hole isn't before its home slot
+		int home = (int)(((unsigned)tasks[slot].pid * 2654435761u) & (unsigned)(taskCapacity - 1));
+		if (((slot - home) & (taskCapacity - 1)) >= ((slot - hole) & (taskCapacity - 1)))
+		{
+			tasks[hole] = tasks[slot];
+			hole = slot;
+		}
+	} // end while
+
+	tasks[hole].pid = 0;
+	taskCount--;
+} // end function remove_task()
+
+void grow_tasks()
+{
+	Task* old = tasks;
+	int oldCapacity = taskCapacity;
+
+	taskCapacity = taskCapacity ? taskCapacity * 2 : 1024;
+	tasks = calloc(taskCapacity, sizeof(Task));
+
+	//Rehash every live task
+	int i;
+	for (i = 0; i < oldCapacity; i++)
+	{
+		if (old[i].pid != 0)
+		{
+			int slot = (int)(((unsigned)old[i].pid * 2654435761u) & (unsigned)(taskCapacity - 1));
+			while (tasks[slot].pid != 0)
+			{
+				slot = (slot + 1) & (taskCapacity - 1);
+			}
+			tasks[slot] = old[i];
+		}
+	} // end for
+
+	free(old);
+} // end function grow_tasks()
+
+void open_job(Task* task, SimTime time)
+{
+	task->runnable = 1;
+	task->arrival = time;
+	task->burst = 0;
+	task->firstRun = -1;
+} // end function open_job()
+
+void emit_job(Task* task, SimTime end)
+{
+	task->runnable = 0;
+
+	//A job that never got the cpu (on the replayed cpu) isn't part of the workload
+	if (task->burst <= 0 || task->firstRun < 0)
+	{
+		return;
+	}
+
+	int pid = add_process(task->arrival, task->burst);
+	processes.task[pid] = task->pid;
+
+	//Keep score of what the kernel did with this job
+	SimTime turnTime = (end - task->arrival);
+	observedSums[0] += (task->firstRun - task->arrival);
+	observedSums[1] += turnTime;
+	observedSums[2] += (turnTime - task->burst);
+	observedJobs++;
+} // end function emit_job()
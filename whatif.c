@@ -0,0 +1,387 @@
+// ******************************************************************************************************************
+//  CPU Scheduler
+//  Copyright(C) 2018  James LoForti
+//  Contact Info: jamesloforti@gmail.com
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.If not, see<https://www.gnu.org/licenses/>.
+//									     ____.           .____             _____  _______   
+//									    |    |           |    |    ____   /  |  | \   _  \  
+//									    |    |   ______  |    |   /  _ \ /   |  |_/  /_\  \ 
+//									/\__|    |  /_____/  |    |__(  <_> )    ^   /\  \_/   \
+//									\________|           |_______ \____/\____   |  \_____  /
+//									                             \/          |__|        \/ 
+//
+// ******************************************************************************************************************
+//
+
+//What-if replays: run a baseline with snapshots kept in memory, edit some bursts, then
+//rerun from the last snapshot before the first edited job arrives. Once the replay reaches
+//a snapshot time in the same state as the baseline, every job still in play finishes as
+//it did in the baseline, so their results are copied over and the replay stops there
+
+#include <stdlib.h> 
+#include <stdio.h> // needed for printf()
+#include <string.h> // needed for memcpy()
+#include <inttypes.h> // needed for PRId64
+#include "p5.h"
+
+//What-if globals
+PER_THREAD int whatIfMode; // 0 when not in a what-if run
+PER_THREAD Snapshot* snapshots; // baseline snapshots, in time order
+PER_THREAD int snapshotCount;
+PER_THREAD int snapshotCapacity;
+PER_THREAD int nextSnapshot; // next baseline snapshot a replay could match
+PER_THREAD ProcessTable baseline; // baseline's final table
+PER_THREAD int* liveRows; // scratch list of rows still in play
+PER_THREAD int* editPids;
+PER_THREAD SimTime* editBursts;
+PER_THREAD int editCount;
+PER_THREAD SimTime rejoinedAt; // -1 until the replay matches the baseline
+
+int parse_edits(char* text)
+{
+	//pid=burst pairs, comma separated
+	editCount = 0;
+	char* cursor = text;
+	while (*cursor)
+	{
+		char* end;
+		long pid = strtol(cursor, &end, 10);
+		if (end == cursor || *end != '=')
+		{
+			return 0;
+		}
+
+		cursor = end + 1;
+		SimTime burst = strtoll(cursor, &end, 10);
+		if (end == cursor || (*end != ',' && *end != '\0'))
+		{
+			return 0;
+		}
+		if (pid < 0 || pid >= numProcesses || burst <= 0)
+		{
+			return 0;
+		}
+
+		editPids = realloc(editPids, sizeof(int) * (editCount + 1));
+		editBursts = realloc(editBursts, sizeof(SimTime) * (editCount + 1));
+		editPids[editCount] = (int)pid;
+		editBursts[editCount] = burst;
+		editCount++;
+
+		cursor = (*end == ',') ? (end + 1) : end;
+	} // end while
+
+	return (editCount > 0);
+} // end function parse_edits()
+
+void what_if(Policy* policy, ProcessTable* original, char** queries, int queryCount)
+{
+	//Space the snapshots evenly over the arrivals
+	SimTime first = processes.arrivalTime[0];
+	SimTime span = processes.arrivalTime[numProcesses - 1] - first;
+	checkpointInterval = span / WHATIF_SNAPSHOTS;
+	if (checkpointInterval < 1)
+	{
+		checkpointInterval = 1;
+	}
+	nextCheckpoint = ((first / checkpointInterval) + 1) * checkpointInterval;
+
+	//Baseline, reported as usual
+	liveRows = realloc(liveRows, sizeof(int) * (numProcesses + 1));
+	whatIfMode = WHATIF_RECORD;
+	policy->run();
+
+	table_reserve(&baseline, processes.capacity);
+	table_copy(&baseline, &processes, numProcesses + 1);
+
+	//Every query replays against the same baseline
+	int i;
+	for (i = 0; i < queryCount; i++)
+	{
+		parse_edits(queries[i]);
+		replay_edits(policy, original);
+	}
+
+	whatIfMode = 0;
+	checkpointInterval = 0;
+	clear_snapshots();
+} // end function what_if()
+
+void replay_edits(Policy* policy, ProcessTable* original)
+{
+	//Apply the edits to a fresh table, noting the first edited arrival
+	init_all();
+	table_copy(&processes, original, numProcesses + 1);
+	SimTime firstEdit = processes.arrivalTime[editPids[0]];
+	int i;
+	for (i = 0; i < editCount; i++)
+	{
+		processes.burstTime[editPids[i]] = editBursts[i];
+		if (processes.arrivalTime[editPids[i]] < firstEdit)
+		{
+			firstEdit = processes.arrivalTime[editPids[i]];
+		}
+	} // end for
+
+	//A burst feeds the guesses for the rest of its task, so those jobs count as edited too.
+	//They all arrive after the edit that moved them, so the first edited arrival still holds
+	if (policy->uses & USES_PREDICTION)
+	{
+		predict_bursts();
+		int edited = editCount;
+		for (i = 0; i < numProcesses; i++)
+		{
+			if (processes.predicted[i] != original->predicted[i])
+			{
+				editPids = realloc(editPids, sizeof(int) * (edited + 1));
+				editPids[edited++] = i;
+			}
+		}
+		editCount = edited;
+	}
+
+	//Edited rows aren't read before they arrive, so any earlier snapshot still holds
+	int start = -1;
+	while (start + 1 < snapshotCount && snapshots[start + 1].header.clock < firstEdit)
+	{
+		start++;
+	}
+
+	//Replay quietly, the averages are printed once the table is complete
+	int wasQuiet = quiet;
+	quiet = 1;
+	whatIfMode = WHATIF_COMPARE;
+	rejoinedAt = -1;
+	SimTime replayedFrom = processes.arrivalTime[0];
+	if (start >= 0)
+	{
+		restore_snapshot(&snapshots[start]);
+		nextSnapshot = start + 1;
+		nextCheckpoint = ((simClock / checkpointInterval) + 1) * checkpointInterval;
+		replayedFrom = simClock;
+		policy->resume();
+	}
+	else
+	{
+		nextSnapshot = 0;
+		nextCheckpoint = ((replayedFrom / checkpointInterval) + 1) * checkpointInterval;
+		policy->run();
+	}
+	quiet = wasQuiet;
+
+	char label[64];
+	snprintf(label, sizeof(label), "What-if (%s)", policy->name);
+	calc_times_and_print(label);
+
+	if (!quiet)
+	{
+		if (rejoinedAt >= 0)
+		{
+			printf("\tReplayed from time %" PRId64 ", rejoined the baseline at time %" PRId64 "\n", replayedFrom, rejoinedAt);
+		}
+		else
+		{
+			printf("\tReplayed from time %" PRId64 " to the end\n", replayedFrom);
+		}
+	}
+} // end function replay_edits()
+
+int what_if_checkpoint()
+{
+	//Keep to the same grid as the baseline
+	nextCheckpoint = ((simClock / checkpointInterval) + 1) * checkpointInterval;
+
+	if (whatIfMode == WHATIF_RECORD)
+	{
+		if (snapshotCount == snapshotCapacity)
+		{
+			snapshotCapacity = snapshotCapacity ? (snapshotCapacity * 2) : 16;
+			snapshots = realloc(snapshots, sizeof(Snapshot) * snapshotCapacity);
+		}
+		take_snapshot(&snapshots[snapshotCount++]);
+		return 1;
+	}
+
+	//Edited jobs still to run can take the schedule anywhere
+	if (!edits_finished())
+	{
+		return 1;
+	}
+
+	//Find the baseline snapshot taken at this time, if it took one
+	while (nextSnapshot < snapshotCount && snapshots[nextSnapshot].header.clock < simClock)
+	{
+		nextSnapshot++;
+	}
+	if (nextSnapshot == snapshotCount || snapshots[nextSnapshot].header.clock != simClock || !matches_snapshot(&snapshots[nextSnapshot]))
+	{
+		return 1;
+	}
+
+	//Same state from here on means the same results, so take them from the baseline
+	Snapshot* snapshot = &snapshots[nextSnapshot];
+	int i;
+	for (i = 0; i < snapshot->liveCount; i++)
+	{
+		table_copy_row(&processes, snapshot->live[i], &baseline, snapshot->live[i]);
+	}
+	for (i = snapshot->header.horizon; i < numProcesses; i++)
+	{
+		table_copy_row(&processes, i, &baseline, i);
+	}
+
+	rejoinedAt = simClock;
+	return 0;
+} // end function what_if_checkpoint()
+
+void take_snapshot(Snapshot* snapshot)
+{
+	//Only rows up to the last arrival can have progressed past their initial state
+	int horizon = 0;
+	while (horizon < numProcesses && processes.arrivalTime[horizon] <= simClock)
+	{
+		horizon++;
+	}
+
+	memset(snapshot, 0, sizeof(Snapshot));
+	snapshot->header.horizon = horizon;
+	snapshot->header.clock = simClock;
+	snapshot->header.running = running;
+	snapshot->header.processesRemaining = processesRemaining;
+	snapshot->header.waitingCount = waitingList.count;
+
+	//Run queue, front to back
+	snapshot->queue = malloc(sizeof(int) * (waitingList.count + 1));
+	int i = 0;
+	Node* next = waitingList.first;
+	while (next != NULL)
+	{
+		snapshot->queue[i++] = next->pid;
+		next = next->next;
+	}
+
+	//Rows still in play
+	snapshot->liveCount = find_live_rows(horizon);
+	snapshot->live = malloc(sizeof(int) * (snapshot->liveCount + 1));
+	memcpy(snapshot->live, liveRows, sizeof(int) * snapshot->liveCount);
+
+	table_reserve(&snapshot->rows, snapshot->liveCount + 1);
+	for (i = 0; i < snapshot->liveCount; i++)
+	{
+		table_copy_row(&snapshot->rows, i, &processes, snapshot->live[i]);
+	}
+} // end function take_snapshot()
+
+void restore_snapshot(Snapshot* snapshot)
+{
+	simClock = snapshot->header.clock;
+	running = snapshot->header.running;
+	processesRemaining = snapshot->header.processesRemaining;
+
+	//Rebuild the run queue
+	int i;
+	for (i = 0; i < snapshot->header.waitingCount; i++)
+	{
+		send_to_waiting(snapshot->queue[i]);
+	}
+
+	//Rows that had finished by then never change again, so the final table has them as they were
+	for (i = 0; i < snapshot->header.horizon; i++)
+	{
+		table_copy_row(&processes, i, &baseline, i);
+	}
+	for (i = 0; i < snapshot->liveCount; i++)
+	{
+		table_copy_row(&processes, snapshot->live[i], &snapshot->rows, i);
+	}
+} // end function restore_snapshot()
+
+int matches_snapshot(Snapshot* snapshot)
+{
+	if (snapshot->header.running != running || snapshot->header.processesRemaining != processesRemaining
+		|| snapshot->header.waitingCount != waitingList.count)
+	{
+		return 0;
+	}
+
+	//Same run queue, in the same order
+	int i = 0;
+	Node* next = waitingList.first;
+	while (next != NULL)
+	{
+		if (snapshot->queue[i++] != next->pid)
+		{
+			return 0;
+		}
+		next = next->next;
+	}
+
+	//Same rows in play, each in the same state
+	if (find_live_rows(snapshot->header.horizon) != snapshot->liveCount)
+	{
+		return 0;
+	}
+	for (i = 0; i < snapshot->liveCount; i++)
+	{
+		if (liveRows[i] != snapshot->live[i] || !table_rows_equal(&processes, liveRows[i], &snapshot->rows, i))
+		{
+			return 0;
+		}
+	}
+
+	return 1;
+} // end function matches_snapshot()
+
+int find_live_rows(int horizon)
+{
+	//Unfinished rows, and the runner even once it's done since the loops still read it
+	int count = 0;
+	int i;
+	for (i = 0; i < horizon; i++)
+	{
+		if (processes.flag[i] != -1 || i == running)
+		{
+			liveRows[count++] = i;
+		}
+	}
+
+	return count;
+} // end function find_live_rows()
+
+int edits_finished()
+{
+	int i;
+	for (i = 0; i < editCount; i++)
+	{
+		if (processes.flag[editPids[i]] != -1 || editPids[i] == running)
+		{
+			return 0;
+		}
+	}
+
+	return 1;
+} // end function edits_finished()
+
+void clear_snapshots()
+{
+	int i;
+	for (i = 0; i < snapshotCount; i++)
+	{
+		free(snapshots[i].queue);
+		free(snapshots[i].live);
+		table_destructor(&snapshots[i].rows);
+	}
+	snapshotCount = 0;
+} // end function clear_snapshots()